@@ -0,0 +1,42 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "flight.h"
+#include "random.h"
+
+// Quantidade de códigos distintos (5 dígitos na base 36, cabem em MAX_LEN).
+#define MAX_FLIGHTS 60466176
+// Semente padrão do gerador.
+#define DEFAULT_SEED 42
+
+int main(int argc, char *argv[])
+{
+    size_t count = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : 0;
+    uint64_t state = argc > 2 ? (uint64_t)strtoull(argv[2], NULL, 10) : DEFAULT_SEED;
+    char id[MAX_LEN] = {0};
+
+    if (count == 0 || count > MAX_FLIGHTS)
+    {
+        fprintf(stderr, "Usage: generate voos [semente] > arquivo.csv\n");
+        return 1;
+    }
+
+    // Códigos únicos, em ordem embaralhada (o código i recebe o i-ésimo múltiplo de um primo)
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t code = (size_t)((i * 16777619ull) % MAX_FLIGHTS);
+        uint64_t fields = next_random(&state);
+
+        for (int digit = MAX_LEN - 2; digit >= 0; digit--, code /= 36)
+            id[digit] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[code % 36];
+
+        printf("%s,%u,%u,%u,%u\n", id,
+               (unsigned)(fields % (MAX_FUEL + 1)),
+               (unsigned)((fields >> 16) % MAX_TIME),
+               (unsigned)((fields >> 32) & 1),
+               (unsigned)((fields >> 40) % 10 == 0));
+    }
+
+    return 0;
+}
@@ -0,0 +1,373 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "flight.h"
+#include "csv.h"
+
+// Quantidade de consultas ao topo medidas juntas em cada amostra (o relógio custa mais que top).
+#define BENCH_BATCH 64
+// Quantidade de vezes que o arquivo é carregado.
+#define LOAD_REPEAT 5
+
+// Amostras de uma operação, em nanossegundos por operação.
+typedef struct
+{
+    const char *name;   //! Nome da operação.
+    double *samples;    //! Tempo por operação de cada amostra.
+    size_t count;       //! Quantidade de amostras.
+    double total;       //! Tempo total, em nanossegundos.
+    size_t operations;  //! Quantidade de operações medidas.
+} Samples;
+
+// Contexto de uma medição.
+typedef struct
+{
+    const char *engine;     //! Nome da estrutura medida.
+    size_t flights;         //! Quantidade de voos do arquivo.
+    double *buffer;         //! Espaço para as amostras de uma operação.
+} Bench;
+
+/**
+ * @brief Retorna o instante atual, em nanossegundos.
+ *
+ * @return double Nanossegundos de um relógio monotônico.
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Compara duas amostras (para qsort).
+ *
+ * @param a Primeira amostra.
+ * @param b Segunda amostra.
+ * @return int Negativo, zero ou positivo, como em strcmp.
+ */
+static int compare_samples(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Começa a medir uma operação.
+ *
+ * @param bench Contexto da medição.
+ * @param name Nome da operação.
+ * @return Samples Amostras vazias, guardadas no buffer do contexto.
+ */
+static Samples start_samples(Bench *bench, const char *name)
+{
+    Samples samples = {name, bench->buffer, 0, 0, 0};
+
+    return samples;
+}
+
+/**
+ * @brief Registra uma amostra.
+ *
+ * @param samples Amostras da operação.
+ * @param elapsed Tempo da amostra, em nanossegundos.
+ * @param operations Quantidade de operações da amostra.
+ */
+static void add_sample(Samples *samples, double elapsed, size_t operations)
+{
+    samples->samples[samples->count++] = elapsed / operations;
+    samples->total += elapsed;
+    samples->operations += operations;
+}
+
+/**
+ * @brief Registra uma amostra de uma única operação, iniciada em `start`.
+ *
+ * @param samples Amostras da operação.
+ * @param start Instante em que a operação começou, em nanossegundos.
+ * @return double Instante atual, que marca o começo da próxima operação.
+ */
+static double next_sample(Samples *samples, double start)
+{
+    double end = now_ns();
+
+    add_sample(samples, end - start, 1);
+
+    return end;
+}
+
+/**
+ * @brief Retorna um percentil das amostras (já ordenadas).
+ *
+ * @param samples Amostras da operação.
+ * @param percentile Percentil, entre 0 e 1.
+ * @return double Valor do percentil.
+ */
+static double percentile(const Samples *samples, double percentile)
+{
+    size_t idx = (size_t)(percentile * (samples->count - 1) + 0.5);
+
+    return samples->samples[idx];
+}
+
+/**
+ * @brief Escreve uma linha do relatório.
+ *
+ * O pico de memória é o do processo até o fim da operação. Sem percentis
+ * (poucas amostras), as colunas correspondentes ficam vazias.
+ *
+ * @param bench Contexto da medição.
+ * @param samples Amostras da operação.
+ * @param percentiles Se os percentis das amostras são escritos.
+ */
+static void report(const Bench *bench, Samples *samples, bool percentiles)
+{
+    struct rusage usage;
+
+    if (samples->count == 0)
+        return;
+
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%s,%s,%zu,%zu,%.1f,", samples->name, bench->engine, bench->flights, samples->operations,
+           samples->total / samples->operations);
+
+    if (percentiles)
+    {
+        qsort(samples->samples, samples->count, sizeof(double), compare_samples);
+        printf("%.1f,%.1f,%.1f,%.1f,", percentile(samples, 0.5), percentile(samples, 0.9),
+               percentile(samples, 0.99), percentile(samples, 0.999));
+    }
+    else
+        printf(",,,,");
+
+    printf("%ld\n", usage.ru_maxrss);
+}
+
+/**
+ * @brief Embaralha um vetor de índices (Fisher-Yates, semente fixa).
+ *
+ * @param order Vetor a ser preenchido com 0 a count - 1, em ordem embaralhada.
+ * @param count Quantidade de índices.
+ */
+static void shuffle(size_t *order, size_t count)
+{
+    uint32_t x = 2463534242u;
+
+    for (size_t i = 0; i < count; i++)
+        order[i] = i;
+
+    for (size_t i = count; i > 1; i--)
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+
+        size_t j = x % i;
+        size_t swap = order[i - 1];
+
+        order[i - 1] = order[j];
+        order[j] = swap;
+    }
+}
+
+/**
+ * @brief Mede o carregamento do arquivo, repetido LOAD_REPEAT vezes.
+ *
+ * Com tão poucas cargas, só o tempo médio é informado.
+ *
+ * @param bench Contexto da medição.
+ * @param file_path Caminho do arquivo.
+ * @return true se o arquivo foi carregado, false caso contrário.
+ */
+static bool bench_load(Bench *bench, char *file_path)
+{
+    Samples samples = start_samples(bench, "load_flights");
+
+    for (size_t i = 0; i < LOAD_REPEAT; i++)
+    {
+        Heap *heap = initialize();
+
+        if (heap == NULL)
+            return false;
+
+        double start = now_ns();
+        bool success = load_flights(file_path, heap);
+        double elapsed = now_ns() - start;
+
+        deallocate(&heap);
+
+        if (!success)
+            return false;
+
+        add_sample(&samples, elapsed, bench->flights);
+    }
+
+    report(bench, &samples, false);
+
+    return true;
+}
+
+/**
+ * @brief Mede insert, top, edição, excluir e pop sobre uma mesma heap.
+ *
+ * A heap recebe todos os voos, é consultada uma vez por voo, tem todos os
+ * voos editados (em ordem embaralhada, cada um com os campos de outro),
+ * perde metade deles por excluir e é esvaziada por pop. Cada operação é uma
+ * amostra, exceto top, medida em lotes de BENCH_BATCH consultas.
+ *
+ * @param bench Contexto da medição.
+ * @param flights Voos do arquivo.
+ * @return true se as operações foram concluídas, false caso contrário.
+ */
+static bool bench_operations(Bench *bench, const Flight *flights)
+{
+    size_t count = bench->flights;
+    size_t *order = (size_t *)malloc(count * sizeof(size_t));
+    Heap *heap = initialize();
+    volatile unsigned sink = 0;
+    Samples samples;
+    Flight removed;
+    double start;
+
+    if (order == NULL || heap == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para o benchmark.\n");
+        free(order);
+        deallocate(&heap);
+        return false;
+    }
+
+    shuffle(order, count);
+
+    samples = start_samples(bench, "insert");
+    start = now_ns();
+
+    // Cada leitura do relógio encerra uma amostra e começa a próxima
+    for (size_t i = 0; i < count; i++)
+    {
+        insert(heap, flights[i]);
+        start = next_sample(&samples, start);
+    }
+
+    report(bench, &samples, true);
+    samples = start_samples(bench, "top");
+
+    for (size_t i = 0; i < count; i += BENCH_BATCH)
+    {
+        size_t end = i + BENCH_BATCH < count ? i + BENCH_BATCH : count;
+
+        start = now_ns();
+
+        for (size_t j = i; j < end; j++)
+            sink += top(heap)->priority;
+
+        add_sample(&samples, now_ns() - start, end - i);
+    }
+
+    report(bench, &samples, true);
+    samples = start_samples(bench, "edit");
+    start = now_ns();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        update_flight(heap, flights[order[i]].id, flights[order[count - 1 - i]]);
+        start = next_sample(&samples, start);
+    }
+
+    report(bench, &samples, true);
+    samples = start_samples(bench, "excluir");
+    start = now_ns();
+
+    for (size_t i = 0; i < count / 2; i++)
+    {
+        excluir(heap, flights[order[i]].id, &removed);
+        start = next_sample(&samples, start);
+    }
+
+    report(bench, &samples, true);
+    samples = start_samples(bench, "pop");
+    start = now_ns();
+
+    while (heap->size > 0)
+    {
+        pop(heap);
+        start = next_sample(&samples, start);
+    }
+
+    report(bench, &samples, true);
+
+    free(order);
+    deallocate(&heap);
+
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    Bench bench = {"binary", 0, NULL};
+    char *file_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--header") == 0)
+        {
+            printf("operacao,estrutura,voos,operacoes,ns_op,p50_ns,p90_ns,p99_ns,p999_ns,pico_rss_kb\n");
+            return 0;
+        }
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc)
+        {
+            bench.engine = argv[++i];
+
+            if (strcmp(bench.engine, "binary") == 0)
+                set_heap_engine(ENGINE_BINARY);
+            else if (strcmp(bench.engine, "bucket") == 0)
+                set_heap_engine(ENGINE_BUCKET);
+            else if (strcmp(bench.engine, "pairing") == 0)
+                set_heap_engine(ENGINE_PAIRING);
+            else
+            {
+                fprintf(stderr, "Estrutura desconhecida: %s.\n", bench.engine);
+                return 1;
+            }
+        }
+        else
+            file_path = argv[i];
+    }
+
+    if (file_path == NULL)
+    {
+        fprintf(stderr, "Usage: operations --header | [--engine binary|bucket|pairing] arquivo.csv\n");
+        return 1;
+    }
+
+    size_t length;
+    char *buffer = read_file(file_path, &length);
+
+    if (buffer == NULL)
+        return 1;
+
+    Flight *flights = parse_flights(file_path, buffer, length, &bench.flights);
+
+    free(buffer);
+
+    // Cada operação tem no máximo uma amostra por voo
+    bench.buffer = (double *)malloc((bench.flights > LOAD_REPEAT ? bench.flights : LOAD_REPEAT) * sizeof(double));
+
+    bool success = flights != NULL && bench.flights > 0 && bench.buffer != NULL &&
+                   bench_load(&bench, file_path) && bench_operations(&bench, flights);
+
+    fflush(stdout);
+    free(bench.buffer);
+    free(flights);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,334 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "flight.h"
+#include "trace.h"
+
+// Nome de cada operação no relatório (índice TraceOp).
+static const char *const OP_NAMES[TRACE_OPS] = {
+    NULL, "state", "insert", "pop", "pop_k", "top", "top_k", "update", "delete", "merge"};
+
+// Latências medidas de um tipo de operação.
+typedef struct
+{
+    double *samples;    //! Latência de cada operação, em nanossegundos.
+    size_t count;       //! Quantidade de operações.
+    size_t capacity;    //! Capacidade do vetor de latências.
+    double total;       //! Soma das latências.
+} Latencies;
+
+/**
+ * @brief Retorna o instante atual, em nanossegundos.
+ *
+ * @return double Nanossegundos de um relógio monotônico.
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Espera até um instante do relógio monotônico.
+ *
+ * @param deadline Instante, em nanossegundos.
+ */
+static void wait_until(double deadline)
+{
+    double remaining = deadline - now_ns();
+
+    if (remaining <= 0)
+        return;
+
+    struct timespec ts = {(time_t)(remaining / 1e9), (long)((long long)remaining % 1000000000LL)};
+
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Compara duas latências (para qsort).
+ *
+ * @param a Primeira latência.
+ * @param b Segunda latência.
+ * @return int Negativo, zero ou positivo, como em strcmp.
+ */
+static int compare_samples(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Registra a latência de uma operação.
+ *
+ * @param latencies Latências do tipo da operação.
+ * @param elapsed Latência, em nanossegundos.
+ * @return true se a latência foi registrada, false se a alocação falhar.
+ */
+static bool add_sample(Latencies *latencies, double elapsed)
+{
+    if (latencies->count == latencies->capacity)
+    {
+        size_t capacity = latencies->capacity == 0 ? 1024 : latencies->capacity * 2;
+        double *samples = (double *)realloc(latencies->samples, capacity * sizeof(double));
+
+        if (samples == NULL)
+            return false;
+
+        latencies->samples = samples;
+        latencies->capacity = capacity;
+    }
+
+    latencies->samples[latencies->count++] = elapsed;
+    latencies->total += elapsed;
+
+    return true;
+}
+
+/**
+ * @brief Retorna um percentil das latências (já ordenadas).
+ *
+ * @param latencies Latências de um tipo de operação.
+ * @param percentile Percentil, entre 0 e 1.
+ * @return double Valor do percentil.
+ */
+static double percentile(const Latencies *latencies, double percentile)
+{
+    return latencies->samples[(size_t)(percentile * (latencies->count - 1) + 0.5)];
+}
+
+/**
+ * @brief Garante espaço para uma quantidade de voos no buffer.
+ *
+ * @param flights Buffer de voos, ampliado se necessário.
+ * @param capacity Capacidade do buffer.
+ * @param count Quantidade de voos.
+ * @return true se o espaço está disponível, false se a alocação falhar.
+ */
+static bool reserve_flights(Flight **flights, size_t *capacity, size_t count)
+{
+    if (count <= *capacity)
+        return true;
+
+    Flight *grown = (Flight *)realloc(*flights, count * sizeof(Flight));
+
+    if (grown == NULL)
+        return false;
+
+    *flights = grown;
+    *capacity = count;
+
+    return true;
+}
+
+/**
+ * @brief Monta uma heap com os voos de um registro (fora da medição).
+ *
+ * @param flights Voos.
+ * @param count Quantidade de voos.
+ * @return Heap* Heap criada ou NULL se a alocação falhar.
+ */
+static Heap *build_batch(const Flight *flights, size_t count)
+{
+    Heap *batch = initialize();
+
+    if (batch == NULL || !reserve(batch, count))
+    {
+        if (batch != NULL)
+            deallocate(&batch);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        insert(batch, flights[i]);
+
+    return batch;
+}
+
+/**
+ * @brief Reproduz um rastro e mede a latência de cada operação.
+ *
+ * @param file Rastro, posicionado após o cabeçalho.
+ * @param paced Reproduz no ritmo original em vez de o mais rápido possível.
+ * @param latencies Latências de cada tipo de operação.
+ * @return true se o rastro foi reproduzido, false caso contrário.
+ */
+static bool replay(FILE *file, bool paced, Latencies latencies[])
+{
+    Heap *heap = initialize();
+    Flight *flights = NULL;
+    size_t capacity = 0;
+    bool success = heap != NULL;
+    double start = now_ns();
+    TraceRecord record;
+
+    while (success && fread(&record, sizeof(record), 1, file) == 1)
+    {
+        size_t payload = trace_payload(&record);
+
+        if (record.op < TRACE_STATE || record.op >= TRACE_OPS ||
+            !reserve_flights(&flights, &capacity, payload > record.count ? payload : record.count) ||
+            fread(flights, sizeof(Flight), payload, file) != payload)
+        {
+            fprintf(stderr, "Rastro corrompido ou memoria insuficiente.\n");
+            success = false;
+            break;
+        }
+
+        // O estado não é medido: a heap é refeita com os voos do registro
+        if (record.op == TRACE_STATE)
+        {
+            Heap *state = build_batch(flights, record.count);
+
+            if ((success = state != NULL))
+            {
+                deallocate(&heap);
+                heap = state;
+            }
+
+            continue;
+        }
+
+        // A heap de origem de uma união é montada antes da medição
+        Heap *batch = NULL;
+
+        if (record.op == TRACE_MERGE && (batch = build_batch(flights, record.count)) == NULL)
+        {
+            success = false;
+            break;
+        }
+
+        if (paced)
+            wait_until(start + (double)record.time);
+
+        double begin = now_ns();
+
+        switch (record.op)
+        {
+        case TRACE_INSERT:
+            insert(heap, flights[0]);
+            break;
+        case TRACE_POP:
+            pop(heap);
+            break;
+        case TRACE_POP_K:
+            pop_k(heap, record.count, flights);
+            break;
+        case TRACE_TOP:
+            top(heap);
+            break;
+        case TRACE_TOP_K:
+            top_k(heap, record.count, flights);
+            break;
+        case TRACE_UPDATE:
+            update_flight(heap, flights[0].id, flights[0]);
+            break;
+        case TRACE_DELETE:
+            excluir(heap, flights[0].id, NULL);
+            break;
+        case TRACE_MERGE:
+            heap_merge(heap, batch);
+            break;
+        }
+
+        success = add_sample(&latencies[record.op], now_ns() - begin);
+
+        if (batch != NULL)
+            deallocate(&batch);
+    }
+
+    if (heap != NULL)
+        deallocate(&heap);
+
+    free(flights);
+
+    if (!success)
+        fprintf(stderr, "Falha ao reproduzir o rastro.\n");
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    Latencies latencies[TRACE_OPS];
+    const char *engine = "binary";
+    const char *file_path = NULL;
+    bool paced = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--paced") == 0)
+            paced = true;
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc)
+        {
+            engine = argv[++i];
+
+            if (strcmp(engine, "binary") == 0)
+                set_heap_engine(ENGINE_BINARY);
+            else if (strcmp(engine, "bucket") == 0)
+                set_heap_engine(ENGINE_BUCKET);
+            else if (strcmp(engine, "pairing") == 0)
+                set_heap_engine(ENGINE_PAIRING);
+            else
+            {
+                fprintf(stderr, "Estrutura desconhecida: %s.\n", engine);
+                return 1;
+            }
+        }
+        else
+            file_path = argv[i];
+    }
+
+    if (file_path == NULL)
+    {
+        fprintf(stderr, "Usage: replay [--engine binary|bucket|pairing] [--paced] rastro\n");
+        return 1;
+    }
+
+    FILE *file = fopen(file_path, "rb");
+
+    if (!file)
+    {
+        fprintf(stderr, "Unable to open file \"%s\".\n", file_path);
+        return 1;
+    }
+
+    memset(latencies, 0, sizeof(latencies));
+
+    bool success = trace_read_header(file, file_path) && replay(file, paced, latencies);
+
+    fclose(file);
+
+    if (success)
+    {
+        printf("operacao,estrutura,operacoes,ns_op,p50_ns,p99_ns,p999_ns,max_ns\n");
+
+        for (int op = TRACE_INSERT; op < TRACE_OPS; op++)
+        {
+            Latencies *current = &latencies[op];
+
+            if (current->count == 0)
+                continue;
+
+            qsort(current->samples, current->count, sizeof(double), compare_samples);
+
+            printf("%s,%s,%zu,%.1f,%.1f,%.1f,%.1f,%.1f\n", OP_NAMES[op], engine, current->count,
+                   current->total / current->count, percentile(current, 0.5), percentile(current, 0.99),
+                   percentile(current, 0.999), current->samples[current->count - 1]);
+        }
+    }
+
+    for (int op = 0; op < TRACE_OPS; op++)
+        free(latencies[op].samples);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dispatcher.h"
+
+// Quantidade de códigos distintos (5 dígitos na base 36, cabem em MAX_LEN).
+#define MAX_FLIGHTS 60466176
+// Quantidade padrão de voos por rodada.
+#define DEFAULT_FLIGHTS 1000000
+// Quantidade máxima padrão de pistas (e de produtores).
+#define DEFAULT_THREADS 8
+
+// Estado compartilhado de uma rodada do benchmark.
+typedef struct
+{
+    Dispatcher *dispatcher; //! Fila de despacho medida.
+    const Flight *flights;  //! Voos a inserir.
+    size_t count;           //! Quantidade de voos.
+    size_t threads;         //! Quantidade de produtores (e de pistas).
+    size_t inserted;        //! Voos inseridos (atualizado atomicamente).
+    size_t finished;        //! Produtores que terminaram (atualizado atomicamente).
+    size_t popped;          //! Voos já retirados (atualizado atomicamente).
+} Round;
+
+// Parâmetros de uma thread do benchmark.
+typedef struct
+{
+    Round *round;   //! Rodada em andamento.
+    size_t id;      //! Número da thread (0 a threads - 1).
+} Worker;
+
+/**
+ * @brief Retorna o instante atual, em segundos.
+ *
+ * @return double Segundos de um relógio monotônico.
+ */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Insere a parte dos voos que cabe a um produtor.
+ *
+ * @param arg Ponteiro para o Worker.
+ * @return void* NULL.
+ */
+static void *produce(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    Round *round = worker->round;
+
+    for (size_t i = worker->id; i < round->count; i += round->threads)
+        if (dispatcher_insert(round->dispatcher, round->flights[i]))
+            __atomic_add_fetch(&round->inserted, 1, __ATOMIC_RELAXED);
+
+    __atomic_add_fetch(&round->finished, 1, __ATOMIC_RELEASE);
+
+    return NULL;
+}
+
+/**
+ * @brief Retira voos até que todos tenham sido despachados (uma pista).
+ *
+ * @param arg Ponteiro para o Worker.
+ * @return void* NULL.
+ */
+static void *consume(void *arg)
+{
+    Worker *worker = (Worker *)arg;
+    Round *round = worker->round;
+    uint32_t seed = 2463534242u + 2654435761u * (uint32_t)worker->id;
+    Flight flight;
+
+    for (;;)
+    {
+        if (dispatcher_pop(round->dispatcher, &seed, &flight))
+            __atomic_add_fetch(&round->popped, 1, __ATOMIC_RELAXED);
+        else if (__atomic_load_n(&round->finished, __ATOMIC_ACQUIRE) == round->threads &&
+                 __atomic_load_n(&round->popped, __ATOMIC_RELAXED) ==
+                     __atomic_load_n(&round->inserted, __ATOMIC_RELAXED))
+            break;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Mede uma rodada: `threads` produtores e `threads` pistas.
+ *
+ * @param flights Voos a inserir.
+ * @param count Quantidade de voos.
+ * @param threads Quantidade de produtores (e de pistas).
+ * @param shards Quantidade de partições da fila.
+ * @return double Operações (inserções e retiradas) por segundo, ou 0 em caso de erro.
+ */
+static double measure(const Flight *flights, size_t count, size_t threads, size_t shards)
+{
+    Round round = {dispatcher_create(shards), flights, count, threads, 0, 0, 0};
+    pthread_t *handles = (pthread_t *)malloc(2 * threads * sizeof(pthread_t));
+    Worker *workers = (Worker *)malloc(threads * sizeof(Worker));
+
+    if (round.dispatcher == NULL || handles == NULL || workers == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para o benchmark.\n");
+        dispatcher_destroy(&round.dispatcher);
+        free(handles);
+        free(workers);
+        return 0;
+    }
+
+    double start = now();
+
+    for (size_t i = 0; i < threads; i++)
+    {
+        workers[i].round = &round;
+        workers[i].id = i;
+        pthread_create(&handles[2 * i], NULL, produce, &workers[i]);
+        pthread_create(&handles[2 * i + 1], NULL, consume, &workers[i]);
+    }
+
+    for (size_t i = 0; i < 2 * threads; i++)
+        pthread_join(handles[i], NULL);
+
+    double elapsed = now() - start;
+
+    dispatcher_destroy(&round.dispatcher);
+    free(handles);
+    free(workers);
+
+    return (round.inserted + round.popped) / elapsed;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t count = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_FLIGHTS;
+    size_t max_threads = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : DEFAULT_THREADS;
+    Flight *flights = (Flight *)malloc(count * sizeof(Flight));
+
+    if (count > MAX_FLIGHTS || flights == NULL || max_threads == 0)
+    {
+        fprintf(stderr, "Usage: runways [voos] [threads]\n");
+        free(flights);
+        return 1;
+    }
+
+    // Voos com códigos únicos e campos sorteados (semente fixa)
+    srand(42);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        char id[MAX_LEN] = {0};
+        size_t code = i;
+
+        for (int digit = MAX_LEN - 2; digit >= 0; digit--, code /= 36)
+            id[digit] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"[code % 36];
+
+        memset(&flights[i], 0, sizeof(Flight));
+        flights[i].id = pack_id(id);
+
+        flights[i].fuel = rand() % (MAX_FUEL + 1);
+        flights[i].time = rand() % (MAX_TIME + 1);
+        flights[i].operation = rand() % 2;
+        flights[i].emergency = rand() % 10 == 0;
+        flights[i].priority = calculate_priority(flights[i]);
+    }
+
+    printf("%zu voos; cada linha usa N produtores e N pistas (Mops/s)\n", count);
+    printf("%8s %14s %14s\n", "N", "trava global", "multiqueue");
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2)
+    {
+        double single = measure(flights, count, threads, 1);
+        double sharded = measure(flights, count, threads, 4 * threads);
+
+        printf("%8zu %14.2f %14.2f\n", threads, single / 1e6, sharded / 1e6);
+    }
+
+    free(flights);
+
+    return 0;
+}
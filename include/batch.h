@@ -0,0 +1,17 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "flight.h"
+#include "network.h"
+
+// Tamanho do buffer da saída padrão nos modos sem interação.
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+// Maior quantidade de voos aceita por POP k e TOP k.
+#define BATCH_MAX_K 4096
+
+// Executa um roteiro de comandos sobre a heap, sem interação.
+bool run_batch(Heap *heap, const char *script_path);
+// Executa um roteiro de comandos sobre uma rede de aeroportos, sem interação.
+bool run_network_batch(Network *network, const char *script_path);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef BUCKET_H
+#define BUCKET_H
+
+#include <limits.h>
+#include <stdint.h>
+
+#include "flight.h"
+
+// Quantidade de prioridades distintas (uma por valor de Flight.priority).
+#define PRIORITY_LEVELS (USHRT_MAX + 1)
+// Marca a ausência de slot.
+#define BUCKET_NONE UINT32_MAX
+
+//== Structs/Enums
+
+// Fila com um balde por prioridade (definida em bucket.c).
+typedef struct Buckets Buckets;
+
+//== Main functions.
+
+// Cria baldes vazios para voos nos slots 0 a capacity - 1.
+Buckets *buckets_create(size_t capacity);
+// Libera os baldes.
+void buckets_destroy(Buckets **buckets);
+// Esvazia todos os baldes.
+void buckets_clear(Buckets *buckets);
+// Acrescenta um slot ao fim do balde de sua prioridade.
+void buckets_push(Buckets *buckets, uint32_t slot, unsigned priority);
+// Retira um slot do balde de sua prioridade.
+void buckets_remove(Buckets *buckets, uint32_t slot, unsigned priority);
+// Retorna o primeiro slot do balde de maior prioridade.
+uint32_t buckets_first(const Buckets *buckets);
+// Retorna o slot seguinte na ordem de despacho.
+uint32_t buckets_next(const Buckets *buckets, uint32_t slot, unsigned priority);
+
+#endif
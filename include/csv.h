@@ -0,0 +1,22 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#include "flight.h"
+
+// Lê um arquivo inteiro para a memória.
+char *read_file(const char *file_path, size_t *length);
+// Conta as linhas de um buffer.
+size_t count_lines(const char *buffer, size_t length);
+// Interpreta uma linha no formato id,combustivel,tempo,operacao,emergencia.
+const char *parse_flight(const char *line, const char *end, Flight *flight);
+// Escreve um voo como uma linha CSV, seguida de sua prioridade.
+void write_flight(FILE *stream, const Flight *flight);
+// Define a quantidade de threads usadas para interpretar arquivos.
+void set_import_threads(size_t threads);
+// Interpreta todas as linhas de um buffer, em paralelo.
+Flight *parse_flights(const char *file_path, const char *buffer, size_t length, size_t *count);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef DISPATCHER_H
+#define DISPATCHER_H
+
+#include <stdint.h>
+
+#include "flight.h"
+
+//== Structs/Enums
+
+// Fila de despacho compartilhada por várias threads (definida em dispatcher.c).
+typedef struct Dispatcher Dispatcher;
+
+//== Main functions.
+
+// Cria uma fila de despacho com `shards` heaps independentes (NULL se `shards` for zero).
+Dispatcher *dispatcher_create(size_t shards);
+// Libera a fila de despacho.
+void dispatcher_destroy(Dispatcher **dispatcher);
+// Insere um voo na fila de despacho (seguro entre threads).
+bool dispatcher_insert(Dispatcher *dispatcher, Flight flight);
+// Retira um voo de alta prioridade da fila de despacho (seguro entre threads).
+bool dispatcher_pop(Dispatcher *dispatcher, uint32_t *seed, Flight *flight);
+// Retorna a quantidade de voos na fila de despacho.
+size_t dispatcher_size(Dispatcher *dispatcher);
+
+#endif
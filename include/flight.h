@@ -4,13 +4,40 @@
 #include <stddef.h>
 #include <ctype.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "stats.h"
 
 #define MAX_LEN 6
-#define MAX_CAPACITY 50
+#define CACHE_LINE 64
+#define INITIAL_CAPACITY 16
+#define MAX_FUEL 1000
+#define MAX_TIME 1440
+
+// Quantidade de filhos de cada nó da heap (definida na compilação).
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 2
+#endif
+
+#if HEAP_ARITY < 2
+#error "HEAP_ARITY deve ser ao menos 2"
+#endif
+
+// Os códigos são empacotados em 64 bits, um byte por caractere (ver pack_id).
+#if MAX_LEN - 1 > 8
+#error "MAX_LEN deve ser no maximo 9"
+#endif
+
+// Remoção de baixo para cima (1) ou clássica, de cima para baixo (0).
+#ifndef HEAP_BOTTOM_UP
+#define HEAP_BOTTOM_UP 1
+#endif
 
 //== Structs/Enums
 
 typedef unsigned short ushort;
+// Código de uma aeronave empacotado em um inteiro (ver pack_id); 0 não é um código válido.
+typedef uint64_t FlightKey;
 typedef enum
 {
     TAKEOFF, //! Decolagem.
@@ -20,7 +47,7 @@ typedef enum
 // Representação de um voo.
 typedef struct
 {
-    char id[MAX_LEN];       //! Código único de uma aeronave.
+    FlightKey id;           //! Código único de uma aeronave (empacotado; ver unpack_id).
     ushort fuel;            //! Quantidade de gasolina de uma aeronave.
     ushort time;            //! Horario de chegada/partida de um voo.
     Operation operation;    //! Tipo de operação.
@@ -28,38 +55,119 @@ typedef struct
     ushort priority;        //! Prioridade de uma aeronave.
 } Flight;
 
+// Estrutura que ordena os voos.
+typedef enum
+{
+    ENGINE_BINARY,  //! Heap d-ária (ver HEAP_ARITY).
+    ENGINE_BUCKET,  //! Um balde por prioridade (ver bucket.h).
+    ENGINE_PAIRING  //! Heap de pareamento, que se une a outra em O(1) (ver pairing.h).
+} Engine;
+
+// Diário de operações (ver journal.h).
+struct Journal;
+// Rastro de operações (ver trace.h).
+struct Trace;
+// Baldes de prioridade (ver bucket.h).
+struct Buckets;
+// Heap de pareamento (ver pairing.h).
+struct Pairing;
+
+// Entrada do índice de IDs (tabela hash com endereçamento aberto).
+typedef struct
+{
+    uint32_t hash;      //! Hash do código da aeronave (0 indica entrada livre).
+    uint32_t slot;      //! Posição da aeronave no repositório de voos.
+} IndexEntry;
+
+// Nó da heap: chave de ordenação e referência ao voo.
+typedef struct
+{
+    uint32_t priority;  //! Prioridade do voo (cópia de Flight.priority).
+    uint32_t slot;      //! Posição do voo no repositório de voos.
+    uint32_t arrival;   //! Ordem de chegada, que desempata prioridades iguais.
+} HeapNode;
+
 // Representação de uma Heap.
 typedef struct
 {
-    Flight data[MAX_CAPACITY];  //! Vetor que armazena as aeronaves.
+    Engine engine;              //! Estrutura que ordena os voos.
+    HeapNode *nodes;            //! Arena (bloco contíguo e alinhado) com os nós, organizados como heap.
+    uint32_t *positions;        //! Posição em `nodes` do voo de cada slot.
+    uint32_t arrivals;          //! Ordem de chegada do próximo voo.
+    struct Buckets *buckets;    //! Baldes de prioridade (apenas ENGINE_BUCKET).
+    struct Pairing *pairing;    //! Heap de pareamento (apenas ENGINE_PAIRING).
+    Flight *flights;            //! Repositório de voos; cada voo permanece no seu slot.
+    uint32_t *free_slots;       //! Pilha de slots livres (capacity - size entradas).
     size_t size;                //! Quantidade de aeronaves.
+    size_t capacity;            //! Quantidade de aeronaves que cabem nos vetores.
+    IndexEntry *index;          //! Índice ID -> slot no repositório.
+    size_t index_capacity;      //! Quantidade de entradas do índice (potência de 2).
+    struct Journal *journal;    //! Diário que registra as alterações (NULL se desativado).
+    struct Trace *trace;        //! Rastro que registra todas as operações (NULL se desativado).
+#if HEAP_STATS
+    HeapStats stats;            //! Contadores de instrumentação (ver stats.h).
+#endif
 } Heap;
 
 //== Aux functions.
 
-// Troca duas aernaves de posição.
-void swap(Flight *a, Flight *b);
+// Empacota um código de aeronave (0 se o código for vazio ou longo demais).
+FlightKey pack_id(const char *id);
+// Desempacota um código de aeronave em um buffer de MAX_LEN caracteres.
+char *unpack_id(FlightKey key, char *id);
+// Aloca uma arena de nós alinhada à linha de cache.
+HeapNode *allocate_arena(size_t capacity);
+// Libera uma arena alocada por allocate_arena.
+void free_arena(HeapNode *arena);
 // Constroi uma arvore heap a partir de um vetor.
 void build_heap(Heap *heap);
 
 //== Main functions.
 
+// Define a estrutura usada pelas próximas heaps inicializadas.
+void set_heap_engine(Engine engine);
 // Inicializa a estrutura heap.
 Heap *initialize();
+// Garante espaço para pelo menos `capacity` aeronaves sem realocar.
+bool reserve(Heap *heap, size_t capacity);
 // Carrega as aeronaves a partir de um arquivo.
 bool load_flights(char *file_path, Heap *heap);
+// Une um vetor de voos à heap, construindo-os de uma só vez.
+bool merge_flights(Heap *heap, const Flight *flights, size_t count);
 // Mantém a propriedade max-heap de uma arvore heap.
 void heapify(Heap *heap, size_t idx);
 // Calcula a prioridade de uma aeronave.
 unsigned calculate_priority(Flight flight);
 // Insere uma aeronave na arvore heap.
-void insert(Heap *heap, Flight flight);
+bool insert(Heap *heap, Flight flight);
 // Remove a aeronave de maior prioridade.
 void pop(Heap *heap);
+// Remove as k aeronaves de maior prioridade, na ordem de despacho.
+size_t pop_k(Heap *heap, size_t k, Flight *out);
 // Retorna a aeronave de maior prioridade.
 Flight* top(Heap* heap);
+// Percorre as aeronaves da heap.
+Flight *next_flight(Heap *heap, size_t *cursor);
+// Copia os k voos de maior prioridade, na ordem de despacho.
+size_t top_k(Heap *heap, size_t k, Flight *out);
+// Lista os slots dos voos na ordem de despacho.
+uint32_t *dispatch_order(Heap *heap);
+// Busca uma aeronave pelo seu código.
+Flight *find_flight(Heap *heap, FlightKey flight_id);
+// Atualiza os dados de uma aeronave e reposiciona-a na heap.
+bool update_flight(Heap *heap, FlightKey flight_id, Flight fields);
 // Remove uma aeronave especifica da heap.
-Flight *excluir(Heap *heap, char flight_id[MAX_LEN]);
+bool excluir(Heap *heap, FlightKey flight_id, Flight *removed);
+// Transfere todas as aeronaves de uma heap para outra.
+bool heap_merge(Heap *dst, Heap *src);
+// Remove todas as aeronaves da heap.
+void clear_flights(Heap *heap);
+// Substitui o conteúdo da heap por um vetor já organizado como heap.
+bool adopt_flights(Heap *heap, Flight *data, size_t size, size_t capacity);
+// Escreve as estatísticas de instrumentação da heap.
+void print_stats(FILE *stream, Heap *heap);
+// Define de quantas em quantas operações as estatísticas são escritas na saída de erros.
+void set_stats_period(Heap *heap, uint64_t period);
 // Desaloca memoria da heap.
 void deallocate(Heap **heap);
 
@@ -10,5 +10,8 @@ void handle_flights_show(Heap *heap);
 void handle_flights_import(Heap *heap);
 void handle_flights_show(Heap *heap);
 void handle_next_flight(Heap *heap);
+void handle_snapshot_save(Heap *heap);
+void handle_snapshot_load(Heap *heap);
+void handle_stats(Heap *heap);
 
 #endif
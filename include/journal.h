@@ -0,0 +1,61 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+
+#include "flight.h"
+
+#define JOURNAL_MAGIC "FLYJ"
+#define JOURNAL_VERSION 1
+// Janela padrão de agrupamento de gravações (em milissegundos).
+#define JOURNAL_DEFAULT_WINDOW 10
+// Quantidade de registros pendentes que força uma gravação antes da janela.
+#define JOURNAL_BATCH 4096
+
+//== Structs/Enums
+
+// Tipo de operação registrada no diário.
+typedef enum
+{
+    JOURNAL_INSERT = 1, //! Inserção de um voo.
+    JOURNAL_POP,        //! Remoção do voo de maior prioridade.
+    JOURNAL_DELETE,     //! Remoção de um voo pelo código.
+    JOURNAL_UPDATE,     //! Atualização dos dados de um voo.
+    JOURNAL_CLEAR       //! Remoção de todos os voos (seguida das inserções do novo conteúdo).
+} JournalOp;
+
+// Cabeçalho de um diário, gravado na criação do arquivo.
+typedef struct
+{
+    char magic[4];          //! Identificador do formato (JOURNAL_MAGIC).
+    uint32_t version;       //! Versão do formato.
+    uint32_t record_size;   //! Tamanho de cada registro (sizeof(JournalRecord)).
+    uint32_t flight_size;   //! Tamanho de cada voo (sizeof(Flight)).
+} JournalHeader;
+
+// Registro (de tamanho fixo) de uma operação no diário.
+typedef struct
+{
+    uint32_t op;        //! Tipo de operação (JournalOp).
+    uint32_t checksum;  //! Hash FNV-1a do registro (com este campo zerado).
+    uint64_t sequence;  //! Número de sequência da operação (a partir de 1).
+    Flight flight;      //! Voo inserido/atualizado ou código do voo removido.
+} JournalRecord;
+
+// Diário de operações (definido em journal.c).
+typedef struct Journal Journal;
+
+// Reaplica na heap as operações registradas em um diário.
+bool journal_replay(Heap *heap, const char *file_path, uint64_t *sequence);
+// Abre um diário para registrar novas operações.
+Journal *journal_open(const char *file_path, uint64_t sequence, unsigned window_ms);
+// Registra uma operação no diário.
+void journal_record(Journal *journal, JournalOp op, const Flight *flight);
+// Retorna o número de sequência da última operação registrada.
+uint64_t journal_sequence(Journal *journal);
+// Aguarda até que todas as operações registradas estejam em disco.
+void journal_sync(Journal *journal);
+// Grava as operações pendentes e fecha o diário.
+void journal_close(Journal **journal);
+
+#endif
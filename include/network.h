@@ -0,0 +1,44 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include <stdio.h>
+
+#include "flight.h"
+
+// Tamanho máximo do código de um aeroporto (incluindo o '\0').
+#define AIRPORT_LEN 5
+// Quantidade de voos que cada aeroporto publica para a visão global.
+#define NETWORK_VIEW 32
+
+//== Structs/Enums
+
+// Voo de um aeroporto da rede.
+typedef struct
+{
+    char airport[AIRPORT_LEN]; //! Código do aeroporto.
+    Flight flight;             //! Voo.
+} NetworkFlight;
+
+// Rede de aeroportos, cada um com a sua heap e a sua thread (definida em network.c).
+typedef struct Network Network;
+
+//== Main functions.
+
+// Cria uma rede sem aeroportos.
+Network *network_create(void);
+// Encerra as threads e libera a rede.
+void network_destroy(Network **network);
+// Interpreta uma linha no formato aeroporto,id,combustivel,tempo,operacao,emergencia.
+const char *parse_network_flight(const char *line, const char *end, NetworkFlight *entry);
+// Carrega os voos de um arquivo, com os aeroportos em paralelo.
+bool network_load(Network *network, const char *file_path);
+// Insere um voo em um aeroporto (sem esperar).
+bool network_insert(Network *network, const char *airport, Flight flight);
+// Retira o voo de maior prioridade de um aeroporto.
+bool network_pop(Network *network, const char *airport, Flight *flight);
+// Espera todos os aeroportos concluírem as operações pendentes (false se alguma inserção foi rejeitada).
+bool network_sync(Network *network);
+// Copia os k voos de maior prioridade de toda a rede.
+size_t network_top_k(Network *network, size_t k, NetworkFlight *out);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef PAIRING_H
+#define PAIRING_H
+
+#include <stdint.h>
+
+#include "flight.h"
+
+// Marca a ausência de slot.
+#define PAIRING_NONE UINT32_MAX
+
+//== Structs/Enums
+
+// Heap de pareamento (definida em pairing.c).
+typedef struct Pairing Pairing;
+
+//== Main functions.
+
+// Cria uma heap de pareamento vazia para voos nos slots 0 a capacity - 1.
+Pairing *pairing_create(size_t capacity);
+// Libera a heap de pareamento.
+void pairing_destroy(Pairing **pairing);
+// Esvazia a heap de pareamento.
+void pairing_clear(Pairing *pairing);
+// Insere um slot na heap de pareamento.
+void pairing_push(Pairing *pairing, uint32_t slot, unsigned priority, uint32_t arrival);
+// Retira um slot da heap de pareamento.
+void pairing_remove(Pairing *pairing, uint32_t slot);
+// Retorna o slot de maior prioridade.
+uint32_t pairing_first(const Pairing *pairing);
+// Retorna o slot seguinte no percurso da heap de pareamento.
+uint32_t pairing_next(const Pairing *pairing, uint32_t slot);
+// Retorna o primeiro filho de um slot.
+uint32_t pairing_child(const Pairing *pairing, uint32_t slot);
+// Retorna o próximo irmão de um slot.
+uint32_t pairing_sibling(const Pairing *pairing, uint32_t slot);
+// Retorna a ordem de chegada de um slot.
+uint32_t pairing_arrival(const Pairing *pairing, uint32_t slot);
+// Incorpora os nós de outra heap de pareamento, com os slots renumerados.
+void pairing_absorb(Pairing *pairing, const Pairing *source, const uint32_t *slots, uint32_t offset);
+
+#endif
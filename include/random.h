@@ -0,0 +1,25 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <stdint.h>
+
+/**
+ * @brief Sorteia o próximo número da sequência (splitmix64).
+ *
+ * A sequência depende apenas da semente, e não da biblioteca C, então a
+ * mesma semente gera os mesmos números em qualquer plataforma.
+ *
+ * @param state Estado do gerador.
+ * @return uint64_t Número sorteado.
+ */
+static inline uint64_t next_random(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+    return z ^ (z >> 31);
+}
+
+#endif
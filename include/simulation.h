@@ -0,0 +1,14 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "flight.h"
+
+// Último minuto em que alguma prioridade ainda cresce (tempo e combustível se esgotam até lá).
+#define SIMULATION_HORIZON (MAX_TIME > MAX_FUEL ? MAX_TIME : MAX_FUEL)
+// Quantidade de classes de envelhecimento (ver simulation.c).
+#define SIMULATION_CLASSES 3
+
+// Simula o despacho minuto a minuto, com a prioridade dos voos envelhecendo.
+bool run_simulation(Heap *heap, size_t rate);
+
+#endif
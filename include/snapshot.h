@@ -0,0 +1,28 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+
+#include "flight.h"
+
+#define SNAPSHOT_MAGIC "FLYS"
+#define SNAPSHOT_VERSION 4
+
+// Cabeçalho de um snapshot binário da heap.
+typedef struct
+{
+    char magic[4];          //! Identificador do formato (SNAPSHOT_MAGIC).
+    uint32_t version;       //! Versão do formato.
+    uint32_t record_size;   //! Tamanho de cada registro (sizeof(Flight)).
+    uint32_t reserved;      //! Reservado (zero).
+    uint64_t count;         //! Quantidade de registros.
+    uint64_t checksum;      //! Hash FNV-1a dos registros.
+    uint64_t sequence;      //! Última operação do diário contida no snapshot.
+} SnapshotHeader;
+
+// Grava o estado da heap em um arquivo binário.
+bool save_snapshot(Heap *heap, const char *file_path);
+// Restaura o estado da heap a partir de um arquivo binário.
+bool load_snapshot(Heap *heap, const char *file_path, uint64_t *sequence);
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Instrumentação da heap (1) ou nenhum custo (0), definida na compilação.
+#ifndef HEAP_STATS
+#define HEAP_STATS 0
+#endif
+
+// Quantidade de faixas de cada histograma.
+#define STATS_BUCKETS 32
+
+//== Structs/Enums
+
+// Operação instrumentada, que recebe as contagens feitas durante ela.
+typedef enum
+{
+    STATS_INSERT,   //! insert.
+    STATS_POP,      //! pop e cada voo de pop_k.
+    STATS_EXCLUIR,  //! excluir.
+    STATS_UPDATE,   //! update_flight (edição).
+    STATS_HEAPIFY,  //! heapify.
+    STATS_OTHER,    //! Demais operações (cargas, uniões e snapshots); sem latência.
+    STATS_OPS       //! Quantidade de operações (não é uma operação).
+} StatsOp;
+
+// Contadores e histogramas de uma heap.
+typedef struct
+{
+    StatsOp current;                                //! Operação em andamento.
+    uint64_t calls[STATS_OPS];                      //! Chamadas concluídas.
+    uint64_t comparisons[STATS_OPS];                //! Comparações entre nós.
+    uint64_t moves[STATS_OPS];                      //! Nós gravados em outra posição.
+    uint64_t depth[STATS_OPS][STATS_BUCKETS];       //! Níveis percorridos por ajuste (um por faixa).
+    uint64_t probes[STATS_OPS][STATS_BUCKETS];      //! Entradas lidas por busca no índice (uma por faixa).
+    uint64_t latency[STATS_OPS][STATS_BUCKETS];     //! Latência em ns (faixa b: até 2^b ns).
+    uint64_t operations;                            //! Total de chamadas concluídas.
+    uint64_t period;                                //! Chamadas entre relatórios automáticos (0 desativa).
+} HeapStats;
+
+//== Macros usadas nas operações da heap (sem efeito com HEAP_STATS 0).
+
+#if HEAP_STATS
+#define STATS_BEGIN(heap, op) double stats_start = stats_begin(&(heap)->stats, (op))
+#define STATS_END(heap) stats_end(&(heap)->stats, stats_start)
+#define STATS_CANCEL(heap) ((heap)->stats.current = STATS_OTHER)
+#define STATS_COUNT(heap, counter, n) ((heap)->stats.counter[(heap)->stats.current] += (n))
+#define STATS_SAMPLE(heap, histogram, value) \
+    stats_sample((heap)->stats.histogram[(heap)->stats.current], (value))
+#else
+#define STATS_BEGIN(heap, op) ((void)0)
+#define STATS_END(heap) ((void)0)
+#define STATS_CANCEL(heap) ((void)0)
+#define STATS_COUNT(heap, counter, n) ((void)0)
+#define STATS_SAMPLE(heap, histogram, value) ((void)(value))
+#endif
+
+//== Main functions.
+
+// Inicializa os contadores.
+void stats_reset(HeapStats *stats);
+// Começa a medir uma operação e retorna o instante inicial.
+double stats_begin(HeapStats *stats, StatsOp op);
+// Conclui a medição iniciada por stats_begin.
+void stats_end(HeapStats *stats, double start);
+// Conta um valor em um histograma de faixas unitárias.
+void stats_sample(uint64_t *histogram, size_t value);
+// Escreve os contadores e histogramas.
+void stats_print(FILE *stream, const HeapStats *stats);
+
+#endif
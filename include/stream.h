@@ -0,0 +1,16 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdio.h>
+
+#include "flight.h"
+
+// Tamanho do bloco lido da entrada a cada leitura.
+#define STREAM_CHUNK_SIZE (1 << 16)
+// Quantidade máxima de voos retirados de uma vez ao despachar.
+#define STREAM_DISPATCH_CHUNK 256
+
+// Consome um fluxo de voos e emite a ordem de despacho.
+bool run_stream(Heap *heap, FILE *input, size_t rate, size_t tick);
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "flight.h"
+
+#define TRACE_MAGIC "FLYT"
+#define TRACE_VERSION 2
+// Tamanho do buffer de gravação do rastro.
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+//== Structs/Enums
+
+// Tipo de operação registrada no rastro.
+typedef enum
+{
+    TRACE_STATE = 1,    //! Conteúdo completo da heap (seguido de `count` voos).
+    TRACE_INSERT,       //! Inserção de um voo.
+    TRACE_POP,          //! Remoção do voo de maior prioridade.
+    TRACE_POP_K,        //! Remoção dos `count` voos de maior prioridade.
+    TRACE_TOP,          //! Consulta do voo de maior prioridade.
+    TRACE_TOP_K,        //! Consulta dos `count` voos de maior prioridade.
+    TRACE_UPDATE,       //! Atualização dos dados de um voo.
+    TRACE_DELETE,       //! Remoção de um voo pelo código.
+    TRACE_MERGE,        //! União com outra heap (seguido de `count` voos).
+    TRACE_OPS           //! Quantidade de tipos (não é uma operação).
+} TraceOp;
+
+// Cabeçalho de um rastro.
+typedef struct
+{
+    char magic[4];          //! Identificador do formato (TRACE_MAGIC).
+    uint32_t version;       //! Versão do formato.
+    uint32_t record_size;   //! Tamanho de cada registro (sizeof(TraceRecord)).
+    uint32_t flight_size;   //! Tamanho de cada voo (sizeof(Flight)).
+} TraceHeader;
+
+// Registro de uma operação, seguido dos voos que ela carrega (ver trace_payload).
+typedef struct
+{
+    uint64_t time;      //! Instante da operação, em nanossegundos desde a abertura do rastro.
+    uint32_t op;        //! Tipo de operação (TraceOp).
+    uint32_t count;     //! k de TRACE_POP_K e TRACE_TOP_K; voos de TRACE_STATE e TRACE_MERGE.
+} TraceRecord;
+
+// Rastro das operações de uma heap (definido em trace.c).
+typedef struct Trace Trace;
+
+// Abre um rastro, começando pelo conteúdo atual da heap.
+Trace *trace_open(const char *file_path, Heap *heap);
+// Registra uma operação no rastro.
+void trace_record(Trace *trace, TraceOp op, const Flight *flight, size_t count);
+// Registra uma operação que carrega todos os voos de uma heap.
+void trace_record_heap(Trace *trace, TraceOp op, Heap *heap);
+// Grava os registros pendentes e fecha o rastro.
+void trace_close(Trace **trace);
+// Retorna a quantidade de voos que seguem um registro.
+size_t trace_payload(const TraceRecord *record);
+// Lê e valida o cabeçalho de um rastro.
+bool trace_read_header(FILE *file, const char *file_path);
+
+#endif
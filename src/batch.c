@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+#include "csv.h"
+
+// Executa um comando de um roteiro sobre o seu alvo (heap ou rede).
+typedef const char *(*CommandRunner)(void *target, const char *line, const char *end);
+
+/**
+ * @brief Verifica se uma linha começa com um comando.
+ *
+ * O comando deve ser seguido por um espaço ou pelo fim da linha.
+ *
+ * @param line Início da linha.
+ * @param end Fim da linha.
+ * @param command Nome do comando.
+ * @param args Recebe o início dos argumentos (após o espaço).
+ * @return true se a linha começa com o comando, false caso contrário.
+ */
+static bool match_command(const char *line, const char *end, const char *command, const char **args)
+{
+    size_t length = strlen(command);
+
+    if ((size_t)(end - line) < length || memcmp(line, command, length) != 0)
+        return false;
+
+    if (line + length == end)
+    {
+        *args = end;
+        return true;
+    }
+
+    if (line[length] != ' ')
+        return false;
+
+    *args = line + length + 1;
+
+    return true;
+}
+
+/**
+ * @brief Copia o argumento de um comando para uma string terminada em '\0'.
+ *
+ * @param args Início do argumento.
+ * @param end Fim da linha.
+ * @param out Buffer de destino.
+ * @param size Tamanho do buffer de destino.
+ * @return true se o argumento não é vazio e coube no buffer, false caso contrário.
+ */
+static bool copy_argument(const char *args, const char *end, char *out, size_t size)
+{
+    size_t length = (size_t)(end - args);
+
+    if (length == 0 || length >= size)
+        return false;
+
+    memcpy(out, args, length);
+    out[length] = '\0';
+
+    return true;
+}
+
+/**
+ * @brief Executa um comando do modo em lote.
+ *
+ * @param target Ponteiro para a heap.
+ * @param line Início da linha do comando.
+ * @param end Fim da linha (sem '\n' nem '\r').
+ * @return const char* NULL em caso de sucesso ou a descrição do erro.
+ */
+static const char *run_command(void *target, const char *line, const char *end)
+{
+    Heap *heap = (Heap *)target;
+    const char *args;
+    char argument[256];
+    Flight flight;
+    bool remove;
+
+    if (match_command(line, end, "INSERT", &args))
+    {
+        const char *error = parse_flight(args, end, &flight);
+
+        if (error != NULL)
+            return error;
+
+        if (!insert(heap, flight))
+            return "insercao rejeitada";
+    }
+    else if (match_command(line, end, "EDIT", &args))
+    {
+        const char *error = parse_flight(args, end, &flight);
+
+        if (error != NULL)
+            return error;
+
+        if (!update_flight(heap, flight.id, flight))
+            return "voo inexistente";
+    }
+    else if (match_command(line, end, "DEL", &args))
+    {
+        // Um código inválido (0) removeria o topo
+        FlightKey key = copy_argument(args, end, argument, sizeof(argument)) ? pack_id(argument) : 0;
+
+        if (key == 0 || !excluir(heap, key, NULL))
+            return "voo inexistente";
+    }
+    else if ((remove = match_command(line, end, "POP", &args)) || match_command(line, end, "TOP", &args))
+    {
+        Flight flights[BATCH_MAX_K];
+        size_t k = 1;
+
+        if (args < end &&
+            (!copy_argument(args, end, argument, sizeof(argument)) ||
+             (k = (size_t)strtoul(argument, NULL, 10)) == 0 || k > BATCH_MAX_K))
+            return "quantidade invalida";
+
+        if (heap->size == 0)
+            return "fila vazia";
+
+        size_t count = remove ? pop_k(heap, k, flights) : top_k(heap, k, flights);
+
+        for (size_t i = 0; i < count; i++)
+            write_flight(stdout, &flights[i]);
+    }
+    else if (match_command(line, end, "SHOW", &args))
+    {
+        size_t cursor = 0;
+        Flight *current;
+
+        while ((current = next_flight(heap, &cursor)) != NULL)
+            write_flight(stdout, current);
+    }
+    else if (match_command(line, end, "IMPORT", &args))
+    {
+        if (!copy_argument(args, end, argument, sizeof(argument)) || !load_flights(argument, heap))
+            return "importacao falhou";
+    }
+    else
+        return "comando desconhecido";
+
+    return NULL;
+}
+
+/**
+ * @brief Executa um comando do modo em lote sobre uma rede de aeroportos.
+ *
+ * @param target Ponteiro para a rede.
+ * @param line Início da linha do comando.
+ * @param end Fim da linha (sem '\n' nem '\r').
+ * @return const char* NULL em caso de sucesso ou a descrição do erro.
+ */
+static const char *run_network_command(void *target, const char *line, const char *end)
+{
+    Network *network = (Network *)target;
+    const char *args;
+    char argument[256];
+    NetworkFlight entry;
+
+    if (match_command(line, end, "INSERT", &args))
+    {
+        const char *error = parse_network_flight(args, end, &entry);
+
+        if (error != NULL)
+            return error;
+
+        if (!network_insert(network, entry.airport, entry.flight))
+            return "insercao rejeitada";
+    }
+    else if (match_command(line, end, "POP", &args))
+    {
+        if (!copy_argument(args, end, entry.airport, AIRPORT_LEN))
+            return "aeroporto invalido";
+
+        if (!network_pop(network, entry.airport, &entry.flight))
+            return "fila vazia";
+
+        printf("%s,", entry.airport);
+        write_flight(stdout, &entry.flight);
+    }
+    else if (match_command(line, end, "TOP", &args))
+    {
+        NetworkFlight view[NETWORK_VIEW];
+        size_t k = 1;
+
+        if (args < end)
+        {
+            if (!copy_argument(args, end, argument, sizeof(argument)) ||
+                (k = (size_t)strtoul(argument, NULL, 10)) == 0 || k > NETWORK_VIEW)
+                return "quantidade invalida";
+        }
+
+        // O roteiro enxerga as próprias operações anteriores
+        bool accepted = network_sync(network);
+        size_t count = network_top_k(network, k, view);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            printf("%s,", view[i].airport);
+            write_flight(stdout, &view[i].flight);
+        }
+
+        if (!accepted)
+            return "insercoes anteriores rejeitadas";
+
+        if (count == 0)
+            return "fila vazia";
+    }
+    else if (match_command(line, end, "IMPORT", &args))
+    {
+        if (!copy_argument(args, end, argument, sizeof(argument)) || !network_load(network, argument))
+            return "importacao falhou";
+    }
+    else
+        return "comando desconhecido";
+
+    return NULL;
+}
+
+/**
+ * @brief Executa cada linha de um roteiro.
+ *
+ * Linhas vazias e linhas iniciadas por '#' são ignoradas. Comandos
+ * inválidos são informados com o número da linha, sem interromper o
+ * roteiro. O roteiro é lido de uma só vez; "-" lê a entrada padrão.
+ *
+ * @param script_path Caminho do roteiro.
+ * @param runner Função que executa cada comando.
+ * @param target Alvo dos comandos (heap ou rede).
+ * @return true se todos os comandos foram executados, false caso contrário.
+ */
+static bool run_script(const char *script_path, CommandRunner runner, void *target)
+{
+    size_t length;
+    char *buffer = read_file(script_path, &length);
+
+    if (buffer == NULL)
+        return false;
+
+    const char *end = buffer + length;
+    size_t line_number = 0;
+    size_t errors = 0;
+
+    for (const char *line = buffer; line < end; line++)
+    {
+        const char *eol = (const char *)memchr(line, '\n', (size_t)(end - line));
+
+        if (eol == NULL)
+            eol = end;
+
+        line_number++;
+
+        const char *stop = eol > line && eol[-1] == '\r' ? eol - 1 : eol;
+
+        // Ignora linhas vazias e comentários
+        if (stop > line && *line != '#')
+        {
+            const char *error = runner(target, line, stop);
+
+            if (error != NULL)
+            {
+                fprintf(stderr, "%s:%zu: %s.\n", script_path, line_number, error);
+                errors++;
+            }
+        }
+
+        line = eol;
+    }
+
+    fflush(stdout);
+    free(buffer);
+
+    return errors == 0;
+}
+
+/**
+ * @brief Executa um roteiro de comandos sobre a heap, sem interação.
+ *
+ * Cada linha do roteiro contém um comando:
+ *
+ *   INSERT id,combustivel,tempo,operacao,emergencia  insere um voo
+ *   EDIT id,combustivel,tempo,operacao,emergencia    atualiza um voo
+ *   DEL id                                           remove um voo pelo código
+ *   POP [k]                                          escreve e remove os k próximos voos (padrão: 1)
+ *   TOP [k]                                          escreve os k próximos voos, sem removê-los
+ *   SHOW                                             escreve todos os voos
+ *   IMPORT arquivo.csv                               importa um arquivo
+ *
+ * Os voos são escritos em CSV (ver write_flight) na saída padrão, que deve
+ * ter buffer grande (ver OUTPUT_BUFFER_SIZE). Ver run_script.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param script_path Caminho do roteiro.
+ * @return true se todos os comandos foram executados, false caso contrário.
+ */
+bool run_batch(Heap *heap, const char *script_path)
+{
+    return run_script(script_path, run_command, heap);
+}
+
+/**
+ * @brief Executa um roteiro de comandos sobre uma rede de aeroportos.
+ *
+ * Cada linha do roteiro contém um comando:
+ *
+ *   INSERT aeroporto,id,combustivel,tempo,operacao,emergencia  insere um voo
+ *   POP aeroporto                                              escreve e remove o próximo voo do aeroporto
+ *   TOP [k]                                                    escreve os k próximos voos da rede (padrão: 1)
+ *   IMPORT arquivo.csv                                         importa um arquivo com a coluna de aeroporto
+ *
+ * Os voos são escritos em CSV, precedidos do aeroporto. As inserções não
+ * são esperadas: as rejeitadas são informadas no próximo TOP ou ao final do
+ * roteiro. Ver run_script.
+ *
+ * @param network Ponteiro para a rede.
+ * @param script_path Caminho do roteiro.
+ * @return true se todos os comandos foram executados, false caso contrário.
+ */
+bool run_network_batch(Network *network, const char *script_path)
+{
+    bool success = run_script(script_path, run_network_command, network);
+
+    if (!network_sync(network))
+    {
+        fprintf(stderr, "%s: insercoes rejeitadas.\n", script_path);
+        success = false;
+    }
+
+    return success;
+}
@@ -0,0 +1,257 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "bucket.h"
+
+// Quantidade de palavras de 64 bits do mapa de baldes não vazios.
+#define BUCKET_WORDS (PRIORITY_LEVELS / 64)
+// Quantidade de palavras do nível intermediário do mapa.
+#define BUCKET_GROUPS (BUCKET_WORDS / 64)
+
+#if PRIORITY_LEVELS % 4096 != 0 || BUCKET_GROUPS > 64
+#error "PRIORITY_LEVELS deve ser multiplo de 4096 e no maximo 262144"
+#endif
+
+// Fila com um balde por prioridade.
+struct Buckets
+{
+    uint32_t *next;                 //! Próximo slot no balde (lista circular).
+    uint32_t *prev;                 //! Slot anterior no balde (o do primeiro é o último).
+    uint64_t summary;               //! Bit g indica groups[g] não vazio.
+    uint64_t groups[BUCKET_GROUPS]; //! Bit w (de cada grupo) indica words[w] não vazio.
+    uint64_t words[BUCKET_WORDS];   //! Bit p indica balde p não vazio.
+    uint32_t heads[PRIORITY_LEVELS]; //! Primeiro slot de cada balde (válido se não vazio).
+};
+
+/**
+ * @brief Calcula a posição do bit mais significativo de uma palavra.
+ *
+ * @param word Palavra não nula.
+ * @return unsigned Posição do bit (0 a 63).
+ */
+static unsigned highest_bit(uint64_t word)
+{
+#if defined(__GNUC__)
+    return 63 - (unsigned)__builtin_clzll(word);
+#else
+    unsigned bit = 0;
+
+    while (word >>= 1)
+        bit++;
+
+    return bit;
+#endif
+}
+
+/**
+ * @brief Localiza o balde não vazio de maior prioridade abaixo de um limite.
+ *
+ * Desce pelo mapa hierárquico: a palavra do limite, depois o grupo e por
+ * fim o resumo, com no máximo três consultas de bit mais significativo.
+ *
+ * @param buckets Ponteiro para os baldes.
+ * @param limit Prioridade limite (exclusiva).
+ * @return long Prioridade do balde ou -1 se não houver.
+ */
+static long highest_below(const Buckets *buckets, unsigned limit)
+{
+    if (limit == 0)
+        return -1;
+
+    unsigned priority = limit - 1;
+    unsigned word = priority / 64;
+    unsigned group = word / 64;
+    uint64_t bits = buckets->words[word] & (~(uint64_t)0 >> (63 - priority % 64));
+
+    if (bits != 0)
+        return (long)word * 64 + highest_bit(bits);
+
+    // Palavras anteriores do mesmo grupo
+    bits = buckets->groups[group] & (((uint64_t)1 << (word % 64)) - 1);
+
+    if (bits == 0)
+    {
+        // Grupos anteriores
+        bits = buckets->summary & (((uint64_t)1 << group) - 1);
+
+        if (bits == 0)
+            return -1;
+
+        group = highest_bit(bits);
+        bits = buckets->groups[group];
+    }
+
+    word = group * 64 + highest_bit(bits);
+
+    return (long)word * 64 + highest_bit(buckets->words[word]);
+}
+
+/**
+ * @brief Cria baldes vazios.
+ *
+ * Os vínculos das listas são indexados pelo slot do voo no repositório da
+ * heap. Apenas o mapa de baldes é zerado; os inícios dos baldes só são lidos
+ * quando o mapa indica que o balde não está vazio.
+ *
+ * @param capacity Quantidade de slots.
+ * @return Buckets* Baldes criados ou NULL se a alocação falhar.
+ */
+Buckets *buckets_create(size_t capacity)
+{
+    Buckets *buckets = (Buckets *)malloc(sizeof(Buckets));
+
+    if (buckets == NULL)
+        return NULL;
+
+    buckets->next = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    buckets->prev = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+
+    if (buckets->next == NULL || buckets->prev == NULL)
+    {
+        buckets_destroy(&buckets);
+        return NULL;
+    }
+
+    buckets_clear(buckets);
+
+    return buckets;
+}
+
+/**
+ * @brief Libera os baldes.
+ *
+ * @param buckets Ponteiro para o ponteiro dos baldes (pode apontar para NULL).
+ */
+void buckets_destroy(Buckets **buckets)
+{
+    if (*buckets == NULL)
+        return;
+
+    free((*buckets)->next);
+    free((*buckets)->prev);
+    free(*buckets);
+    *buckets = NULL;
+}
+
+/**
+ * @brief Esvazia todos os baldes.
+ *
+ * Basta zerar o mapa de baldes não vazios.
+ *
+ * @param buckets Ponteiro para os baldes.
+ */
+void buckets_clear(Buckets *buckets)
+{
+    buckets->summary = 0;
+    memset(buckets->groups, 0, sizeof(buckets->groups));
+    memset(buckets->words, 0, sizeof(buckets->words));
+}
+
+/**
+ * @brief Acrescenta um slot ao fim do balde de sua prioridade, em O(1).
+ *
+ * Slots com a mesma prioridade saem na ordem em que foram acrescentados.
+ *
+ * @param buckets Ponteiro para os baldes.
+ * @param slot Slot do voo.
+ * @param priority Prioridade do voo (menor que PRIORITY_LEVELS).
+ */
+void buckets_push(Buckets *buckets, uint32_t slot, unsigned priority)
+{
+    unsigned word = priority / 64;
+    uint64_t bit = (uint64_t)1 << (priority % 64);
+
+    if ((buckets->words[word] & bit) == 0)
+    {
+        buckets->heads[priority] = slot;
+        buckets->next[slot] = slot;
+        buckets->prev[slot] = slot;
+
+        buckets->words[word] |= bit;
+        buckets->groups[word / 64] |= (uint64_t)1 << (word % 64);
+        buckets->summary |= (uint64_t)1 << (word / 64);
+        return;
+    }
+
+    uint32_t head = buckets->heads[priority];
+    uint32_t tail = buckets->prev[head];
+
+    buckets->next[tail] = slot;
+    buckets->prev[slot] = tail;
+    buckets->next[slot] = head;
+    buckets->prev[head] = slot;
+}
+
+/**
+ * @brief Retira um slot do balde de sua prioridade, em O(1).
+ *
+ * @param buckets Ponteiro para os baldes.
+ * @param slot Slot do voo (presente no balde).
+ * @param priority Prioridade do voo.
+ */
+void buckets_remove(Buckets *buckets, uint32_t slot, unsigned priority)
+{
+    uint32_t next = buckets->next[slot];
+
+    if (next != slot)
+    {
+        uint32_t prev = buckets->prev[slot];
+
+        buckets->next[prev] = next;
+        buckets->prev[next] = prev;
+
+        if (buckets->heads[priority] == slot)
+            buckets->heads[priority] = next;
+
+        return;
+    }
+
+    // Último slot do balde: limpa os bits que ficaram vazios
+    unsigned word = priority / 64;
+
+    buckets->words[word] &= ~((uint64_t)1 << (priority % 64));
+
+    if (buckets->words[word] == 0)
+    {
+        buckets->groups[word / 64] &= ~((uint64_t)1 << (word % 64));
+
+        if (buckets->groups[word / 64] == 0)
+            buckets->summary &= ~((uint64_t)1 << (word / 64));
+    }
+}
+
+/**
+ * @brief Retorna o primeiro slot do balde de maior prioridade, em O(1).
+ *
+ * @param buckets Ponteiro para os baldes.
+ * @return uint32_t Slot ou BUCKET_NONE se todos os baldes estiverem vazios.
+ */
+uint32_t buckets_first(const Buckets *buckets)
+{
+    long priority = highest_below(buckets, PRIORITY_LEVELS);
+
+    return priority < 0 ? BUCKET_NONE : buckets->heads[priority];
+}
+
+/**
+ * @brief Retorna o slot seguinte na ordem de despacho.
+ *
+ * O seguinte é o próximo do mesmo balde ou, no fim dele, o primeiro do
+ * próximo balde não vazio de menor prioridade.
+ *
+ * @param buckets Ponteiro para os baldes.
+ * @param slot Slot atual.
+ * @param priority Prioridade do slot atual.
+ * @return uint32_t Slot seguinte ou BUCKET_NONE no fim.
+ */
+uint32_t buckets_next(const Buckets *buckets, uint32_t slot, unsigned priority)
+{
+    uint32_t next = buckets->next[slot];
+
+    if (next != buckets->heads[priority])
+        return next;
+
+    long lower = highest_below(buckets, priority);
+
+    return lower < 0 ? BUCKET_NONE : buckets->heads[lower];
+}
@@ -0,0 +1,518 @@
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "csv.h"
+
+// Menor trecho (em bytes) que compensa o custo de uma thread
+#define MIN_CHUNK_LENGTH (1 << 20)
+
+// Linha inválida encontrada durante a interpretação de um trecho.
+typedef struct
+{
+    size_t line;            //! Número da linha dentro do trecho (a partir de 1).
+    const char *message;    //! Descrição do erro.
+} ParseError;
+
+// Trecho do arquivo interpretado por uma thread.
+typedef struct
+{
+    const char *begin;      //! Início do trecho (início de uma linha).
+    const char *end;        //! Fim do trecho (após um '\n' ou fim do buffer).
+    Flight *flights;        //! Voos interpretados, na ordem do arquivo.
+    size_t count;           //! Quantidade de voos interpretados.
+    size_t lines;           //! Quantidade de linhas do trecho.
+    ParseError *errors;     //! Linhas inválidas, na ordem do arquivo.
+    size_t error_count;     //! Quantidade de linhas inválidas.
+    size_t error_capacity;  //! Capacidade do vetor de erros.
+    bool failed;            //! Indica falha de alocação.
+} ParseChunk;
+
+// Quantidade de threads usadas na importação.
+static size_t import_threads = 1;
+
+/**
+ * @brief Lê todo o conteúdo de um fluxo para a memória.
+ *
+ * Usada quando o tamanho não é conhecido de antemão (como na entrada
+ * padrão): o buffer é lido em blocos e dobra de tamanho quando enche.
+ *
+ * @param stream Fluxo a ser lido.
+ * @param length Recebe a quantidade de bytes lidos.
+ * @return char* Buffer alocado terminado por '\0' (liberar com free) ou NULL
+ *               se faltar memória.
+ */
+static char *read_stream(FILE *stream, size_t *length)
+{
+    size_t capacity = 1 << 16;
+    char *buffer = (char *)malloc(capacity);
+
+    *length = 0;
+
+    while (buffer != NULL)
+    {
+        *length += fread(buffer + *length, 1, capacity - *length - 1, stream);
+
+        if (*length < capacity - 1)
+            break;
+
+        char *grown = (char *)realloc(buffer, capacity * 2);
+
+        if (grown == NULL)
+            free(buffer);
+
+        buffer = grown;
+        capacity *= 2;
+    }
+
+    if (buffer == NULL)
+        fprintf(stderr, "Memoria insuficiente para ler a entrada.\n");
+    else
+        buffer[*length] = '\0';
+
+    return buffer;
+}
+
+/**
+ * @brief Lê um arquivo inteiro para a memória.
+ *
+ * O arquivo é lido com uma única chamada a fread para um buffer do seu
+ * tamanho, terminado por '\0'. As linhas são interpretadas diretamente
+ * nesse buffer, sem cópias intermediárias. O caminho "-" representa a
+ * entrada padrão.
+ *
+ * @param file_path Caminho do arquivo.
+ * @param length Recebe a quantidade de bytes lidos.
+ * @return char* Buffer alocado com o conteúdo do arquivo (liberar com free)
+ *               ou NULL em caso de erro.
+ */
+char *read_file(const char *file_path, size_t *length)
+{
+    if (strcmp(file_path, "-") == 0)
+        return read_stream(stdin, length);
+
+    // Tenta abrir o arquivo para leitura
+    FILE *input_file = fopen(file_path, "rb");
+
+    // Se o arquivo não puder ser aberto, exibe uma mensagem de erro
+    if (!input_file)
+    {
+        fprintf(stderr, "Unable to read file \"%s\": %s.\n", file_path, strerror(errno));
+        return NULL;
+    }
+
+    // Descobre o tamanho do arquivo
+    long size = -1;
+
+    if (fseek(input_file, 0, SEEK_END) == 0)
+        size = ftell(input_file);
+
+    if (size < 0 || fseek(input_file, 0, SEEK_SET) != 0)
+    {
+        fprintf(stderr, "Unable to read file \"%s\": %s.\n", file_path, strerror(errno));
+        fclose(input_file);
+        return NULL;
+    }
+
+    char *buffer = (char *)malloc((size_t)size + 1);
+
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para ler \"%s\".\n", file_path);
+        fclose(input_file);
+        return NULL;
+    }
+
+    *length = fread(buffer, 1, (size_t)size, input_file);
+    buffer[*length] = '\0';
+
+    // Fecha o arquivo após terminar a leitura
+    fclose(input_file);
+
+    return buffer;
+}
+
+/**
+ * @brief Conta as linhas de um buffer.
+ *
+ * Uma última linha sem '\n' também é contada. Usada para reservar espaço na
+ * heap antes de uma carga em massa.
+ *
+ * @param buffer Conteúdo a ser percorrido.
+ * @param length Quantidade de bytes do buffer.
+ * @return size_t Quantidade de linhas.
+ */
+size_t count_lines(const char *buffer, size_t length)
+{
+    const char *end = buffer + length;
+    size_t lines = 0;
+
+    // memchr percorre o buffer em blocos, bem mais rápido que byte a byte
+    for (const char *p = buffer; p < end; p++, lines++)
+    {
+        p = (const char *)memchr(p, '\n', (size_t)(end - p));
+
+        if (p == NULL)
+            return lines + 1;
+    }
+
+    return lines;
+}
+
+/**
+ * @brief Ignora espaços e tabulações.
+ *
+ * @param p Posição atual.
+ * @param end Fim da linha.
+ * @return const char* Primeira posição que não é espaço nem tabulação.
+ */
+static const char *skip_blanks(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t'))
+        p++;
+
+    return p;
+}
+
+/**
+ * @brief Decodifica um campo numérico sem sinal.
+ *
+ * Lê os dígitos decimais a partir de `p`, ignorando espaços ao redor, e
+ * rejeita campos vazios ou com valor acima de `max`.
+ *
+ * @param p Início do campo.
+ * @param end Fim da linha.
+ * @param max Maior valor aceito.
+ * @param value Recebe o valor decodificado.
+ * @return const char* Posição logo após o campo ou NULL se o campo for inválido.
+ */
+static const char *parse_number(const char *p, const char *end, unsigned max, ushort *value)
+{
+    unsigned number = 0;
+
+    p = skip_blanks(p, end);
+
+    if (p == end || *p < '0' || *p > '9')
+        return NULL;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+    {
+        number = number * 10 + (unsigned)(*p - '0');
+
+        if (number > max)
+            return NULL;
+    }
+
+    *value = (ushort)number;
+
+    return skip_blanks(p, end);
+}
+
+/**
+ * @brief Interpreta uma linha no formato id,combustivel,tempo,operacao,emergencia.
+ *
+ * A linha é lida diretamente do buffer (sem cópia) e cada campo é validado:
+ * o código deve ter de 1 a MAX_LEN - 1 caracteres (e é empacotado por
+ * pack_id), o combustível deve estar
+ * entre 0 e MAX_FUEL, o tempo entre 0 e MAX_TIME - 1 e a operação e a
+ * emergência devem valer 0 ou 1. Um '\r' final é ignorado. Em caso de
+ * sucesso, a prioridade do voo também é calculada.
+ *
+ * @param line Início da linha.
+ * @param end Fim da linha (posição do '\n' ou do fim do buffer).
+ * @param flight Recebe o voo lido.
+ * @return const char* NULL em caso de sucesso ou a descrição do erro.
+ */
+const char *parse_flight(const char *line, const char *end, Flight *flight)
+{
+    ushort operation;
+
+    if (end > line && end[-1] == '\r')
+        end--;
+
+    // Código da aeronave
+    const char *comma = (const char *)memchr(line, ',', (size_t)(end - line));
+
+    if (comma == NULL)
+        return "quantidade de campos invalida";
+
+    size_t id_length = (size_t)(comma - line);
+    char id[MAX_LEN] = {0};
+
+    if (id_length >= MAX_LEN)
+        return "ID deve ter de 1 a 5 caracteres";
+
+    // O código é empacotado uma única vez, na leitura
+    memcpy(id, line, id_length);
+
+    if ((flight->id = pack_id(id)) == 0)
+        return "ID deve ter de 1 a 5 caracteres";
+
+    // Campos numéricos, separados por vírgula
+    const char *p = comma + 1;
+
+    if ((p = parse_number(p, end, MAX_FUEL, &flight->fuel)) == NULL)
+        return "combustivel invalido";
+
+    if (p == end || *p++ != ',')
+        return "quantidade de campos invalida";
+
+    if ((p = parse_number(p, end, MAX_TIME - 1, &flight->time)) == NULL)
+        return "tempo invalido";
+
+    if (p == end || *p++ != ',')
+        return "quantidade de campos invalida";
+
+    if ((p = parse_number(p, end, 1, &operation)) == NULL)
+        return "operacao invalida";
+
+    if (p == end || *p++ != ',')
+        return "quantidade de campos invalida";
+
+    if ((p = parse_number(p, end, 1, &flight->emergency)) == NULL)
+        return "emergencia invalida";
+
+    if (p != end)
+        return "quantidade de campos invalida";
+
+    // Converte o código da operação para o tipo correto
+    flight->operation = (Operation)operation;
+
+    // Calcula a prioridade do voo
+    flight->priority = calculate_priority(*flight);
+
+    return NULL;
+}
+
+/**
+ * @brief Escreve um voo como uma linha CSV, seguida de sua prioridade.
+ *
+ * O formato é id,combustivel,tempo,operacao,emergencia,prioridade, isto é,
+ * o mesmo lido por parse_flight acrescido da prioridade calculada.
+ *
+ * @param stream Fluxo de saída.
+ * @param flight Voo a ser escrito.
+ */
+void write_flight(FILE *stream, const Flight *flight)
+{
+    char id[MAX_LEN];
+
+    fprintf(stream, "%s,%u,%u,%u,%u,%u\n", unpack_id(flight->id, id), flight->fuel, flight->time,
+            (unsigned)flight->operation, flight->emergency, flight->priority);
+}
+
+/**
+ * @brief Define a quantidade de threads usadas para interpretar arquivos.
+ *
+ * @param threads Quantidade de threads (valores menores que 1 equivalem a 1).
+ */
+void set_import_threads(size_t threads)
+{
+    import_threads = threads < 1 ? 1 : threads;
+}
+
+/**
+ * @brief Registra uma linha inválida de um trecho.
+ *
+ * @param chunk Trecho sendo interpretado.
+ * @param line Número da linha dentro do trecho.
+ * @param message Descrição do erro.
+ */
+static void add_error(ParseChunk *chunk, size_t line, const char *message)
+{
+    if (chunk->error_count == chunk->error_capacity)
+    {
+        size_t capacity = chunk->error_capacity == 0 ? 16 : chunk->error_capacity * 2;
+        ParseError *errors = (ParseError *)realloc(chunk->errors, capacity * sizeof(ParseError));
+
+        if (errors == NULL)
+        {
+            chunk->failed = true;
+            return;
+        }
+
+        chunk->errors = errors;
+        chunk->error_capacity = capacity;
+    }
+
+    chunk->errors[chunk->error_count].line = line;
+    chunk->errors[chunk->error_count].message = message;
+    chunk->error_count++;
+}
+
+/**
+ * @brief Interpreta todas as linhas de um trecho.
+ *
+ * Função executada por cada thread. Os voos são gravados no vetor próprio do
+ * trecho, dimensionado pela quantidade de linhas, e as linhas inválidas são
+ * apenas registradas, para que sejam exibidas em ordem ao final.
+ *
+ * @param arg Ponteiro para o ParseChunk a ser interpretado.
+ * @return void* Sempre NULL.
+ */
+static void *parse_chunk(void *arg)
+{
+    ParseChunk *chunk = (ParseChunk *)arg;
+    size_t capacity = count_lines(chunk->begin, (size_t)(chunk->end - chunk->begin));
+
+    chunk->flights = (Flight *)malloc((capacity > 0 ? capacity : 1) * sizeof(Flight));
+
+    if (chunk->flights == NULL)
+    {
+        chunk->failed = true;
+        return NULL;
+    }
+
+    for (const char *line = chunk->begin; line < chunk->end; line++)
+    {
+        const char *eol = (const char *)memchr(line, '\n', (size_t)(chunk->end - line));
+
+        if (eol == NULL)
+            eol = chunk->end;
+
+        chunk->lines++;
+
+        // Ignora linhas vazias
+        if (eol > line && !(eol - line == 1 && *line == '\r'))
+        {
+            const char *error = parse_flight(line, eol, &chunk->flights[chunk->count]);
+
+            if (error == NULL)
+                chunk->count++;
+            else
+                add_error(chunk, chunk->lines, error);
+        }
+
+        line = eol;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Interpreta todas as linhas de um buffer.
+ *
+ * O buffer é dividido em trechos de tamanhos próximos, sempre em fronteiras
+ * de linha, e cada trecho é interpretado por uma thread (ver
+ * set_import_threads). Arquivos pequenos usam menos threads, já que cada
+ * trecho deve ter ao menos MIN_CHUNK_LENGTH bytes. Os vetores de cada thread
+ * são concatenados na ordem do arquivo, de modo que o resultado é idêntico
+ * ao da leitura serial. Linhas inválidas são exibidas com seu número.
+ *
+ * @param file_path Caminho do arquivo (usado nas mensagens de erro).
+ * @param buffer Conteúdo do arquivo.
+ * @param length Quantidade de bytes do buffer.
+ * @param count Recebe a quantidade de voos interpretados.
+ * @return Flight* Vetor de voos (liberar com free) ou NULL em caso de erro.
+ */
+Flight *parse_flights(const char *file_path, const char *buffer, size_t length, size_t *count)
+{
+    size_t threads = import_threads;
+
+    if (threads > length / MIN_CHUNK_LENGTH)
+        threads = length / MIN_CHUNK_LENGTH;
+
+    if (threads < 1)
+        threads = 1;
+
+    ParseChunk *chunks = (ParseChunk *)calloc(threads, sizeof(ParseChunk));
+    pthread_t *workers = (pthread_t *)malloc(threads * sizeof(pthread_t));
+
+    if (chunks == NULL || workers == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para ler \"%s\".\n", file_path);
+        free(chunks);
+        free(workers);
+        return NULL;
+    }
+
+    // Divide o buffer em trechos terminados em fim de linha
+    const char *end = buffer + length;
+    const char *begin = buffer;
+
+    for (size_t i = 0; i < threads; i++)
+    {
+        const char *split = i == threads - 1 ? end : buffer + length / threads * (i + 1);
+
+        if (split < begin)
+            split = begin;
+
+        if (split < end)
+        {
+            split = (const char *)memchr(split, '\n', (size_t)(end - split));
+            split = split == NULL ? end : split + 1;
+        }
+
+        chunks[i].begin = begin;
+        chunks[i].end = split;
+        begin = split;
+    }
+
+    // A thread atual interpreta o primeiro trecho
+    size_t started = 1;
+
+    for (; started < threads; started++)
+        if (pthread_create(&workers[started], NULL, parse_chunk, &chunks[started]) != 0)
+            break;
+
+    parse_chunk(&chunks[0]);
+
+    // Trechos cujas threads não puderam ser criadas são interpretados aqui
+    for (size_t i = started; i < threads; i++)
+        parse_chunk(&chunks[i]);
+
+    for (size_t i = 1; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    // Exibe os erros em ordem e concatena os voos
+    Flight *flights = NULL;
+    size_t total = 0;
+    size_t first_line = 0;
+    bool failed = false;
+
+    for (size_t i = 0; i < threads; i++)
+    {
+        for (size_t e = 0; e < chunks[i].error_count; e++)
+            fprintf(stderr, "%s:%zu: %s.\n", file_path, first_line + chunks[i].errors[e].line, chunks[i].errors[e].message);
+
+        first_line += chunks[i].lines;
+        total += chunks[i].count;
+        failed = failed || chunks[i].failed;
+    }
+
+    if (failed)
+        fprintf(stderr, "Memoria insuficiente para ler \"%s\".\n", file_path);
+    else if (threads == 1)
+    {
+        // Com um único trecho, seu vetor já é o resultado
+        flights = chunks[0].flights;
+        chunks[0].flights = NULL;
+    }
+    else if ((flights = (Flight *)malloc((total > 0 ? total : 1) * sizeof(Flight))) != NULL)
+    {
+        size_t offset = 0;
+
+        for (size_t i = 0; i < threads; i++)
+        {
+            memcpy(flights + offset, chunks[i].flights, chunks[i].count * sizeof(Flight));
+            offset += chunks[i].count;
+        }
+    }
+    else
+        fprintf(stderr, "Memoria insuficiente para ler \"%s\".\n", file_path);
+
+    for (size_t i = 0; i < threads; i++)
+    {
+        free(chunks[i].flights);
+        free(chunks[i].errors);
+    }
+
+    free(chunks);
+    free(workers);
+
+    *count = total;
+
+    return flights;
+}
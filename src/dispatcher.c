@@ -0,0 +1,297 @@
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "dispatcher.h"
+
+// Leitura e escrita do topo de uma partição sem a sua trava.
+#if defined(__GNUC__)
+#define LOAD_TOP(shard) __atomic_load_n(&(shard)->top, __ATOMIC_RELAXED)
+#define STORE_TOP(shard, value) __atomic_store_n(&(shard)->top, (value), __ATOMIC_RELAXED)
+#else
+#define LOAD_TOP(shard) ((shard)->top)
+#define STORE_TOP(shard, value) ((shard)->top = (value))
+#endif
+
+// Partição da fila de despacho: uma heap comum protegida por uma trava.
+typedef struct
+{
+    pthread_mutex_t lock;   //! Protege a heap.
+    Heap *heap;             //! Voos da partição.
+    unsigned top;           //! Prioridade do topo mais 1 (0 se vazia), lida sem a trava.
+    char padding[CACHE_LINE]; //! Mantém partições vizinhas em linhas de cache distintas.
+} Shard;
+
+// Fila de despacho compartilhada (MultiQueue).
+struct Dispatcher
+{
+    Shard *shards;  //! Partições.
+    size_t count;   //! Quantidade de partições.
+};
+
+/**
+ * @brief Sorteia uma partição.
+ *
+ * Gerador xorshift de 32 bits, com o estado guardado pela thread chamadora.
+ *
+ * @param dispatcher Ponteiro para a fila de despacho.
+ * @param seed Estado do gerador (não nulo).
+ * @return Shard* Partição sorteada.
+ */
+static Shard *random_shard(Dispatcher *dispatcher, uint32_t *seed)
+{
+    uint32_t x = *seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+
+    return &dispatcher->shards[x % dispatcher->count];
+}
+
+/**
+ * @brief Calcula a partição responsável por um código de voo.
+ *
+ * Cada código pertence a uma única partição, o que mantém os códigos únicos
+ * em toda a fila.
+ *
+ * @param dispatcher Ponteiro para a fila de despacho.
+ * @param id Código empacotado da aeronave.
+ * @return Shard* Partição do código.
+ */
+static Shard *shard_of(Dispatcher *dispatcher, FlightKey id)
+{
+    uint32_t hash = (uint32_t)(id * UINT64_C(0x9E3779B97F4A7C15) >> 32);
+
+    return &dispatcher->shards[hash % dispatcher->count];
+}
+
+/**
+ * @brief Atualiza o topo publicado de uma partição (com a trava adquirida).
+ *
+ * @param shard Ponteiro para a partição.
+ */
+static void publish_top(Shard *shard)
+{
+    STORE_TOP(shard, shard->heap->size == 0 ? 0u : (unsigned)top(shard->heap)->priority + 1u);
+}
+
+/**
+ * @brief Retira o topo de uma partição (com a trava adquirida).
+ *
+ * @param shard Ponteiro para a partição.
+ * @param flight Recebe o voo retirado.
+ * @return true se a partição tinha voos, false caso contrário.
+ */
+static bool take(Shard *shard, Flight *flight)
+{
+    if (shard->heap->size == 0)
+        return false;
+
+    *flight = *top(shard->heap);
+    pop(shard->heap);
+    publish_top(shard);
+
+    return true;
+}
+
+/**
+ * @brief Cria uma fila de despacho.
+ *
+ * A fila é uma MultiQueue: `shards` heaps comuns, cada uma com a sua
+ * trava. Com uma única partição, ela equivale a uma heap protegida por uma
+ * trava global. Com mais partições, produtores e consumidores raramente
+ * disputam a mesma trava; recomenda-se cerca de duas partições por thread.
+ *
+ * @param shards Quantidade de partições (maior que zero).
+ * @return Dispatcher* Fila criada ou NULL se `shards` for zero ou a alocação falhar.
+ */
+Dispatcher *dispatcher_create(size_t shards)
+{
+    Dispatcher *dispatcher;
+
+    // Sem partições, não há para onde distribuir os códigos
+    if (shards == 0)
+        return NULL;
+
+    dispatcher = (Dispatcher *)malloc(sizeof(Dispatcher));
+
+    if (dispatcher == NULL)
+        return NULL;
+
+    dispatcher->shards = (Shard *)malloc(shards * sizeof(Shard));
+    dispatcher->count = 0;
+
+    if (dispatcher->shards == NULL)
+    {
+        free(dispatcher);
+        return NULL;
+    }
+
+    for (; dispatcher->count < shards; dispatcher->count++)
+    {
+        Shard *shard = &dispatcher->shards[dispatcher->count];
+
+        if ((shard->heap = initialize()) == NULL)
+            break;
+
+        if (pthread_mutex_init(&shard->lock, NULL) != 0)
+        {
+            deallocate(&shard->heap);
+            break;
+        }
+
+        shard->top = 0;
+    }
+
+    if (dispatcher->count < shards)
+        dispatcher_destroy(&dispatcher);
+
+    return dispatcher;
+}
+
+/**
+ * @brief Libera a fila de despacho.
+ *
+ * Nenhuma thread pode estar usando a fila.
+ *
+ * @param dispatcher Ponteiro para o ponteiro da fila (pode apontar para NULL).
+ */
+void dispatcher_destroy(Dispatcher **dispatcher)
+{
+    if (*dispatcher == NULL)
+        return;
+
+    for (size_t i = 0; i < (*dispatcher)->count; i++)
+    {
+        pthread_mutex_destroy(&(*dispatcher)->shards[i].lock);
+        deallocate(&(*dispatcher)->shards[i].heap);
+    }
+
+    free((*dispatcher)->shards);
+    free(*dispatcher);
+    *dispatcher = NULL;
+}
+
+/**
+ * @brief Insere um voo na fila de despacho.
+ *
+ * O voo vai para a partição do seu código (ver shard_of), com as mesmas
+ * regras de insert. Pode ser chamada por várias threads ao mesmo tempo.
+ *
+ * @param dispatcher Ponteiro para a fila de despacho.
+ * @param flight O voo a ser inserido, com prioridade calculada.
+ * @return true se o voo foi inserido, false caso contrário.
+ */
+bool dispatcher_insert(Dispatcher *dispatcher, Flight flight)
+{
+    Shard *shard = shard_of(dispatcher, flight.id);
+
+    pthread_mutex_lock(&shard->lock);
+
+    bool success = insert(shard->heap, flight);
+
+    if (success)
+        publish_top(shard);
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return success;
+}
+
+/**
+ * @brief Retira um voo de alta prioridade da fila de despacho.
+ *
+ * Sorteia duas partições, compara os topos publicados (sem travas) e retira
+ * o topo da melhor, se a sua trava estiver livre; caso contrário, sorteia
+ * de novo. A ordem é relaxada: o voo retirado não é necessariamente o de
+ * maior prioridade, mas o seu posto esperado na fila é O(partições). Se os
+ * sorteios só encontrarem partições vazias, todas são percorridas antes de
+ * concluir que a fila está vazia. Pode ser chamada por várias threads ao
+ * mesmo tempo, cada uma com o seu `seed`.
+ *
+ * @param dispatcher Ponteiro para a fila de despacho.
+ * @param seed Estado do gerador de sorteios da thread (não nulo).
+ * @param flight Recebe o voo retirado.
+ * @return true se um voo foi retirado, false se a fila estava vazia.
+ */
+bool dispatcher_pop(Dispatcher *dispatcher, uint32_t *seed, Flight *flight)
+{
+    size_t misses = 0;
+
+    // Com uma única partição, a fila é uma heap com trava global
+    if (dispatcher->count == 1)
+    {
+        Shard *shard = &dispatcher->shards[0];
+
+        pthread_mutex_lock(&shard->lock);
+        bool success = take(shard, flight);
+        pthread_mutex_unlock(&shard->lock);
+
+        return success;
+    }
+
+    while (misses < dispatcher->count)
+    {
+        Shard *first = random_shard(dispatcher, seed);
+        Shard *second = random_shard(dispatcher, seed);
+        Shard *best = LOAD_TOP(second) > LOAD_TOP(first) ? second : first;
+
+        if (LOAD_TOP(best) == 0)
+        {
+            misses++;
+            continue;
+        }
+
+        if (pthread_mutex_trylock(&best->lock) != 0)
+            continue;
+
+        bool success = take(best, flight);
+
+        pthread_mutex_unlock(&best->lock);
+
+        if (success)
+            return true;
+
+        misses++;
+    }
+
+    // Confirma, partição por partição, que a fila está vazia
+    for (size_t i = 0; i < dispatcher->count; i++)
+    {
+        Shard *shard = &dispatcher->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        bool success = take(shard, flight);
+        pthread_mutex_unlock(&shard->lock);
+
+        if (success)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Retorna a quantidade de voos na fila de despacho.
+ *
+ * Com outras threads em atividade, o valor é apenas aproximado.
+ *
+ * @param dispatcher Ponteiro para a fila de despacho.
+ * @return size_t Quantidade de voos.
+ */
+size_t dispatcher_size(Dispatcher *dispatcher)
+{
+    size_t size = 0;
+
+    for (size_t i = 0; i < dispatcher->count; i++)
+    {
+        Shard *shard = &dispatcher->shards[i];
+
+        pthread_mutex_lock(&shard->lock);
+        size += shard->heap->size;
+        pthread_mutex_unlock(&shard->lock);
+    }
+
+    return size;
+}
@@ -6,323 +6,1983 @@
 #include <string.h>
 #include <time.h>
 #include <limits.h>
+#include <stdint.h>
 
 #include "flight.h"
+#include "bucket.h"
+#include "pairing.h"
+#include "csv.h"
+#include "journal.h"
+#include "trace.h"
+
+static bool append(Heap *heap, Flight flight);
+static void restore_heap(Heap *heap, size_t first);
+static uint32_t oldest_arrival(Heap *heap);
+static Engine default_engine = ENGINE_BINARY;
+
+/**
+ * @brief Empacota um código de aeronave em um inteiro.
+ *
+ * Cada caractere ocupa um byte, o primeiro no mais significativo dos
+ * 8 * (MAX_LEN - 1) bits usados, e as posições após o fim do código ficam
+ * zeradas. Assim, a conversão é reversível (ver unpack_id), dois códigos são
+ * iguais se e somente se suas chaves forem iguais e a ordem das chaves é a
+ * mesma de strcmp.
+ *
+ * @param id Código da aeronave.
+ * @return FlightKey Código empacotado ou 0 se o código for NULL, vazio ou
+ *         tiver mais de MAX_LEN - 1 caracteres.
+ */
+FlightKey pack_id(const char *id)
+{
+    FlightKey key = 0;
+    size_t length = 0;
+
+    if (id == NULL)
+        return 0;
+
+    for (; length < MAX_LEN - 1 && id[length] != '\0'; length++)
+        key = key << 8 | (unsigned char)id[length];
+
+    if (id[length] != '\0')
+        return 0;
+
+    return key << 8 * (MAX_LEN - 1 - length);
+}
+
+/**
+ * @brief Desempacota um código de aeronave.
+ *
+ * @param key Código empacotado por pack_id.
+ * @param id Buffer de MAX_LEN caracteres que recebe o código.
+ * @return char* O próprio buffer, para uso direto em printf.
+ */
+char *unpack_id(FlightKey key, char *id)
+{
+    for (size_t i = 0; i < MAX_LEN - 1; i++)
+        id[i] = (char)(key >> 8 * (MAX_LEN - 2 - i) & 0xFF);
+
+    id[MAX_LEN - 1] = '\0';
+
+    return id;
+}
+
+/**
+ * @brief Calcula o hash de um código de aeronave.
+ *
+ * Multiplica a chave pela constante de Fibonacci de 64 bits e usa os bits
+ * altos do produto, que dependem de todos os caracteres. O valor 0 é
+ * reservado para as entradas livres do índice.
+ *
+ * @param key Código empacotado.
+ * @return uint32_t Valor do hash (nunca 0).
+ */
+static uint32_t hash_key(FlightKey key)
+{
+    uint32_t hash = (uint32_t)(key * UINT64_C(0x9E3779B97F4A7C15) >> 32);
+
+    return hash != 0 ? hash : 1;
+}
+
+/**
+ * @brief Localiza a entrada do índice correspondente a um código.
+ *
+ * Percorre a tabela por sondagem linear a partir do hash do código até
+ * encontrar a entrada com o código ou uma entrada livre. O índice guarda
+ * apenas o hash e o slot; quando o hash coincide, o código é confirmado no
+ * próprio voo, com uma única comparação de inteiros.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param key Código empacotado.
+ * @return size_t Posição da entrada no índice (ocupada pelo código ou livre).
+ */
+static size_t index_slot(Heap *heap, FlightKey key)
+{
+    size_t mask = heap->index_capacity - 1;
+    uint32_t hash = hash_key(key);
+    size_t slot = hash & mask;
+    size_t probes = 1;
+
+    for (; heap->index[slot].hash != 0 &&
+           (heap->index[slot].hash != hash || heap->flights[heap->index[slot].slot].id != key);
+         probes++)
+        slot = (slot + 1) & mask;
+
+    STATS_SAMPLE(heap, probes, probes);
+
+    return slot;
+}
+
+/**
+ * @brief Associa um código ao slot do seu voo no repositório.
+ *
+ * Cria a entrada caso o código ainda não esteja no índice ou atualiza o
+ * slot caso já esteja. O voo já deve estar gravado no slot.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param key Código empacotado.
+ * @param slot Posição da aeronave no repositório de voos.
+ */
+static void index_set(Heap *heap, FlightKey key, uint32_t slot)
+{
+    IndexEntry *entry = &heap->index[index_slot(heap, key)];
+
+    entry->hash = hash_key(key);
+    entry->slot = slot;
+}
+
+/**
+ * @brief Remove um código do índice.
+ *
+ * Após liberar a entrada, desloca para trás as entradas seguintes da mesma
+ * sequência de sondagem, de modo que nenhuma busca seja interrompida pelo
+ * buraco (dispensando marcadores de remoção).
+ *
+ * @param heap Ponteiro para a heap.
+ * @param key Código empacotado.
+ */
+static void index_remove(Heap *heap, FlightKey key)
+{
+    size_t mask = heap->index_capacity - 1;
+    size_t hole = index_slot(heap, key);
+
+    if (heap->index[hole].hash == 0)
+        return;
+
+    for (size_t next = (hole + 1) & mask; heap->index[next].hash != 0; next = (next + 1) & mask)
+    {
+        size_t home = heap->index[next].hash & mask;
+
+        // A entrada pode ocupar o buraco se ele estiver entre sua posição ideal e a atual
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            heap->index[hole] = heap->index[next];
+            hole = next;
+        }
+    }
+
+    heap->index[hole].hash = 0;
+}
+
+/**
+ * @brief Aloca uma arena de nós alinhada à linha de cache.
+ *
+ * A arena é posicionada de modo que o nó de índice 1, primeiro filho da
+ * raiz, comece em uma fronteira de linha de cache. Cada nó tem 12 bytes
+ * (prioridade, slot e ordem de chegada, todos de 32 bits), e os filhos do nó
+ * i ocupam as posições HEAP_ARITY * i + 1 em diante, de modo que um grupo de
+ * irmãos ocupa 12 * HEAP_ARITY bytes contíguos. Só o primeiro grupo tem o
+ * início alinhado; os demais podem atravessar uma linha a mais. O endereço
+ * devolvido por malloc é guardado logo antes da arena.
+ *
+ * @param capacity Quantidade de nós que a arena deve comportar.
+ * @return HeapNode* Arena alocada (liberar com free_arena) ou NULL se a alocação falhar.
+ */
+HeapNode *allocate_arena(size_t capacity)
+{
+    if (capacity > (SIZE_MAX - 2 * CACHE_LINE - sizeof(void *)) / sizeof(HeapNode))
+        return NULL;
+
+    char *block = (char *)malloc(capacity * sizeof(HeapNode) + 2 * CACHE_LINE + sizeof(void *));
+
+    if (block == NULL)
+        return NULL;
+
+    uintptr_t line = ((uintptr_t)(block + sizeof(void *)) + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1);
+    char *arena = (char *)line + (CACHE_LINE - sizeof(HeapNode) % CACHE_LINE) % CACHE_LINE;
+
+    memcpy(arena - sizeof(void *), &block, sizeof(void *));
+
+    return (HeapNode *)arena;
+}
+
+/**
+ * @brief Libera uma arena alocada por allocate_arena.
+ *
+ * @param arena Arena a ser liberada (pode ser NULL).
+ */
+void free_arena(HeapNode *arena)
+{
+    char *block;
+
+    if (arena == NULL)
+        return;
+
+    memcpy(&block, (char *)arena - sizeof(void *), sizeof(void *));
+    free(block);
+}
+
+/**
+ * @brief Calcula a quantidade de entradas do índice para uma capacidade.
+ *
+ * @param capacity Capacidade da heap.
+ * @return size_t Menor potência de 2 que seja ao menos o dobro da capacidade.
+ */
+static size_t index_capacity_for(size_t capacity)
+{
+    size_t index_capacity = 1;
+
+    while (index_capacity < 2 * capacity)
+        index_capacity *= 2;
+
+    return index_capacity;
+}
+
+/**
+ * @brief Instala um repositório de voos na heap, compactado em ordem de heap.
+ *
+ * O voo do slot i de `flights` passa a ser o i-ésimo na ordem da estrutura:
+ * o nó i da heap binária, que deve estar organizada como heap (ou ser
+ * reorganizada em seguida por build_heap), o próximo do seu balde, que
+ * recebe os voos na ordem em que aparecem, ou mais um nó da heap de
+ * pareamento. Aloca a estrutura, a pilha de slots livres (os menores no
+ * topo) e o índice de IDs para `capacity` voos e libera os vetores
+ * anteriores. Em caso de falha, nada é alterado e `flights` continua sendo
+ * do chamador.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param flights Repositório de voos (alocado com malloc).
+ * @param size Quantidade de voos em `flights`.
+ * @param capacity Quantidade de voos que cabem em `flights` (>= size).
+ * @param arrivals Ordem de chegada de cada voo (NULL para usar a posição).
+ * @return true se o repositório foi instalado, false se a alocação falhar.
+ */
+static bool install(Heap *heap, Flight *flights, size_t size, size_t capacity, const uint32_t *arrivals)
+{
+    // Os slots e posições têm 32 bits; evita também overflow no tamanho em bytes
+    if (capacity > UINT32_MAX || capacity > SIZE_MAX / (2 * sizeof(IndexEntry)))
+        return false;
+
+    HeapNode *nodes = NULL;
+    uint32_t *positions = NULL;
+    Buckets *buckets = NULL;
+    Pairing *pairing = NULL;
+    bool ready;
+
+    switch (heap->engine)
+    {
+    case ENGINE_BUCKET:
+        ready = (buckets = buckets_create(capacity)) != NULL;
+        break;
+    case ENGINE_PAIRING:
+        ready = (pairing = pairing_create(capacity)) != NULL;
+        break;
+    default:
+        nodes = allocate_arena(capacity);
+        positions = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+        ready = nodes != NULL && positions != NULL;
+        break;
+    }
+
+    size_t index_capacity = index_capacity_for(capacity);
+    uint32_t *free_slots = (uint32_t *)malloc(capacity * sizeof(uint32_t));
+    IndexEntry *index = (IndexEntry *)calloc(index_capacity, sizeof(IndexEntry));
+
+    if (!ready || free_slots == NULL || index == NULL)
+    {
+        free_arena(nodes);
+        free(positions);
+        buckets_destroy(&buckets);
+        pairing_destroy(&pairing);
+        free(free_slots);
+        free(index);
+        return false;
+    }
+
+    free_arena(heap->nodes);
+    free(heap->flights);
+    free(heap->positions);
+    buckets_destroy(&heap->buckets);
+    pairing_destroy(&heap->pairing);
+    free(heap->free_slots);
+    free(heap->index);
+
+    heap->nodes = nodes;
+    heap->positions = positions;
+    heap->buckets = buckets;
+    heap->pairing = pairing;
+    heap->flights = flights;
+    heap->free_slots = free_slots;
+    heap->size = size;
+    heap->capacity = capacity;
+    heap->index = index;
+    heap->index_capacity = index_capacity;
+
+    for (size_t i = 0; i < size; i++)
+    {
+        uint32_t arrival = arrivals != NULL ? arrivals[i] : (uint32_t)i;
+
+        index_set(heap, flights[i].id, (uint32_t)i);
+
+        if (buckets != NULL)
+            buckets_push(buckets, (uint32_t)i, flights[i].priority);
+        else if (pairing != NULL)
+            pairing_push(pairing, (uint32_t)i, flights[i].priority, arrival);
+        else
+        {
+            nodes[i].priority = flights[i].priority;
+            nodes[i].slot = (uint32_t)i;
+            nodes[i].arrival = arrival;
+            positions[i] = (uint32_t)i;
+        }
+    }
+
+    // O slot livre de menor número fica no topo da pilha
+    for (size_t i = 0; i < capacity - size; i++)
+        free_slots[i] = (uint32_t)(capacity - 1 - i);
+
+    return true;
+}
+
+/**
+ * @brief Obtém a ordem de chegada de um voo.
+ *
+ * @param heap Ponteiro para a heap (binária ou de pareamento).
+ * @param slot Slot do voo.
+ * @return uint32_t Ordem de chegada.
+ */
+static uint32_t arrival_of(const Heap *heap, uint32_t slot)
+{
+    if (heap->engine == ENGINE_PAIRING)
+        return pairing_arrival(heap->pairing, slot);
+
+    return heap->nodes[heap->positions[slot]].arrival;
+}
+
+/**
+ * @brief Redimensiona os vetores da heap.
+ *
+ * Copia os voos, na ordem da estrutura, para um novo repositório que comporta
+ * exatamente `capacity` elementos e o instala (ver install), o que também
+ * compacta os slots deixados livres pelas remoções. A capacidade nunca fica
+ * abaixo de INITIAL_CAPACITY nem abaixo da quantidade de voos armazenados. O
+ * índice de IDs acompanha a capacidade, mantendo ao menos o dobro de
+ * entradas (fator de carga <= 0,5).
+ *
+ * @param heap Ponteiro para a heap.
+ * @param capacity Nova capacidade desejada.
+ * @return true se a heap foi redimensionada, false se a alocação falhar.
+ */
+static bool resize(Heap *heap, size_t capacity)
+{
+    if (capacity < INITIAL_CAPACITY)
+        capacity = INITIAL_CAPACITY;
+
+    if (capacity < heap->size)
+        capacity = heap->size;
+
+    if (capacity == heap->capacity)
+        return true;
+
+    if (capacity > SIZE_MAX / sizeof(Flight))
+        return false;
+
+    Flight *flights = (Flight *)malloc(capacity * sizeof(Flight));
+
+    if (flights == NULL)
+        return false;
+
+    // Guarda também a ordem de chegada, que os baldes não precisam
+    uint32_t *arrivals = NULL;
+
+    if (heap->engine != ENGINE_BUCKET && heap->size > 0)
+    {
+        arrivals = (uint32_t *)malloc(heap->size * sizeof(uint32_t));
+
+        if (arrivals == NULL)
+        {
+            free(flights);
+            return false;
+        }
+    }
+
+    size_t cursor = 0;
+    Flight *flight;
+
+    for (size_t i = 0; (flight = next_flight(heap, &cursor)) != NULL; i++)
+    {
+        flights[i] = *flight;
+
+        if (arrivals != NULL)
+            arrivals[i] = arrival_of(heap, (uint32_t)(flight - heap->flights));
+    }
+
+    bool success = install(heap, flights, heap->size, capacity, arrivals);
+
+    if (!success)
+        free(flights);
+
+    free(arrivals);
+
+    return success;
+}
+
+/**
+ * @brief Define a estrutura usada pelas próximas heaps inicializadas.
+ *
+ * Todas as estruturas têm a mesma ordem de despacho: maior prioridade
+ * primeiro e, entre prioridades iguais, ordem de chegada.
+ *
+ * @param engine Estrutura (ENGINE_BINARY é o padrão).
+ */
+void set_heap_engine(Engine engine)
+{
+    default_engine = engine;
+}
+
+/**
+ * @brief Cria uma heap vazia com uma estrutura de ordenação.
+ *
+ * @param engine Estrutura de ordenação.
+ * @return Heap* Ponteiro para a heap criada ou NULL se a alocação falhar.
+ */
+static Heap *create_heap(Engine engine)
+{
+    // Aloca memória para a heap
+    Heap *heap = (Heap *)malloc(sizeof(Heap));
+
+    // Verifica se a alocação foi bem-sucedida
+    if (heap == NULL)
+        return NULL;
+
+    // Inicializa a heap vazia, sem vetores e sem índice
+    heap->engine = engine;
+    heap->nodes = NULL;
+    heap->positions = NULL;
+    heap->arrivals = 0;
+    heap->buckets = NULL;
+    heap->pairing = NULL;
+    heap->flights = NULL;
+    heap->free_slots = NULL;
+    heap->size = 0;
+    heap->capacity = 0;
+    heap->index = NULL;
+    heap->index_capacity = 0;
+    heap->journal = NULL;
+    heap->trace = NULL;
+#if HEAP_STATS
+    stats_reset(&heap->stats);
+#endif
+
+    // Aloca os vetores com a capacidade inicial
+    if (!resize(heap, INITIAL_CAPACITY))
+    {
+        free(heap);
+        return NULL;
+    }
+
+    return heap;
+}
 
 /**
  * @brief Inicializa uma nova heap.
  *
- * Aloca memória para uma heap e inicializa o tamanho como zero.
+ * Aloca memória para uma heap, para sua estrutura de ordenação (ver
+ * set_heap_engine) e seu repositório de voos, com capacidade inicial
+ * INITIAL_CAPACITY, e para seu índice de IDs, e inicializa o tamanho como
+ * zero.
+ *
+ * @return Heap* Ponteiro para a heap inicializada ou NULL se a alocação falhar.
+ */
+Heap *initialize()
+{
+    return create_heap(default_engine);
+}
+
+/**
+ * @brief Reserva espaço na heap para uma quantidade de voos.
+ *
+ * Garante que a heap comporte pelo menos `capacity` voos, de modo que
+ * inserções em massa (como em load_flights) não precisem realocar no meio
+ * da carga. Nunca reduz a capacidade atual.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param capacity Quantidade mínima de voos que a heap deve comportar.
+ * @return true se o espaço está disponível, false se a alocação falhar.
+ */
+bool reserve(Heap *heap, size_t capacity)
+{
+    if (capacity <= heap->capacity)
+        return true;
+
+    return resize(heap, capacity);
+}
+
+/**
+ * @brief Une um vetor de voos à heap, construindo-os de uma só vez.
+ *
+ * Os voos, já com prioridade calculada, formam uma heap própria, da mesma
+ * estrutura, construída de uma só vez (ver restore_heap) em O(m), que é
+ * então unida à heap por heap_merge. A ordem de `flights` é a ordem de
+ * chegada, que desempata prioridades iguais. Voos com código repetido são
+ * informados e ignorados, como em insert.
+ *
+ * @param heap Ponteiro para a heap onde os voos serão armazenados.
+ * @param flights Voos a unir (continuam sendo do chamador).
+ * @param count Quantidade de voos em `flights`.
+ * @return true se os voos foram unidos, false se a alocação falhar.
+ */
+bool merge_flights(Heap *heap, const Flight *flights, size_t count)
+{
+    Heap *batch = create_heap(heap->engine);
+
+    // Reserva espaço para todos os voos antes de anexar
+    if (batch == NULL || !reserve(batch, count))
+    {
+        fprintf(stderr, "Memoria insuficiente para carregar os voos.\n");
+
+        if (batch != NULL)
+            deallocate(&batch);
+
+        return false;
+    }
+
+    // Com o espaço reservado, append só recusa códigos repetidos
+    for (size_t i = 0; i < count; i++)
+        append(batch, flights[i]);
+
+    // Ajusta os voos anexados de uma só vez e une o lote à heap
+    restore_heap(batch, 0);
+
+    bool success = heap_merge(heap, batch);
+
+    deallocate(&batch);
+
+    return success;
+}
+
+/**
+ * @brief Carrega os voos de um arquivo e insere na heap.
+ *
+ * Lê o arquivo especificado pelo caminho de uma só vez e interpreta suas
+ * linhas diretamente no buffer, possivelmente em várias threads (ver
+ * parse_flights). Linhas inválidas são informadas com seu número e
+ * ignoradas; linhas vazias são ignoradas. Os voos lidos são unidos à heap
+ * de uma só vez (ver merge_flights).
+ *
+ * @param file_path Caminho do arquivo contendo os dados dos voos.
+ * @param heap Ponteiro para a heap onde os voos serão armazenados.
+ * @return true se o arquivo foi lido, false caso contrário.
+ */
+bool load_flights(char *file_path, Heap *heap)
+{
+    size_t length;
+    char *buffer = read_file(file_path, &length);
+
+    // Se o arquivo não puder ser lido, o erro já foi exibido
+    if (buffer == NULL)
+        return false;
+
+    size_t count;
+    Flight *flights = parse_flights(file_path, buffer, length, &count);
+
+    free(buffer);
+
+    if (flights == NULL)
+        return false;
+
+    bool success = merge_flights(heap, flights, count);
+
+    free(flights);
+
+    return success;
+}
+
+/**
+ * @brief Calcula a prioridade de um voo.
+ *
+ * A prioridade é calculada com base no combustível, tempo de voo, operação e emergência.
+ *
+ * @param flight O voo cujo a prioridade será calculada.
+ * @return unsigned Valor da prioridade calculada.
+ */
+unsigned calculate_priority(Flight flight)
+{
+    return (MAX_FUEL - flight.fuel) + (MAX_TIME - flight.time) + 500 * (flight.operation) + 500 * (flight.emergency);
+}
+
+/**
+ * @brief Calcula a posição do pai de um nó na heap d-ária.
+ *
+ * @param idx Posição do nó (maior que zero).
+ * @return size_t Posição do pai.
+ */
+static inline size_t parent(size_t idx)
+{
+    return (idx - 1) / HEAP_ARITY;
+}
+
+/**
+ * @brief Calcula a posição do primeiro filho de um nó na heap d-ária.
+ *
+ * Os filhos ocupam as HEAP_ARITY posições consecutivas a partir desta.
+ *
+ * @param idx Posição do nó.
+ * @return size_t Posição do primeiro filho.
+ */
+static inline size_t first_child(size_t idx)
+{
+    return HEAP_ARITY * idx + 1;
+}
+
+/**
+ * @brief Verifica se um nó deve sair antes de outro.
+ *
+ * Vence a maior prioridade e, entre prioridades iguais, a chegada mais
+ * antiga. A ordem de chegada é comparada em aritmética modular, o que
+ * suporta a volta do contador enquanto os voos presentes chegaram dentro de
+ * uma janela de 2^31 chegadas.
+ *
+ * @param a Primeiro nó.
+ * @param b Segundo nó.
+ * @return true se `a` sai antes de `b`, false caso contrário.
+ */
+static inline bool precedes(HeapNode a, HeapNode b)
+{
+    if (a.priority != b.priority)
+        return a.priority > b.priority;
+
+    return (uint32_t)(b.arrival - a.arrival - 1) < UINT32_C(0x7FFFFFFF);
+}
+
+/**
+ * @brief Grava um nó em uma posição da heap.
+ *
+ * Atualiza também a posição do voo referenciado pelo nó.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param idx Posição de destino.
+ * @param node Nó a ser gravado.
+ */
+static inline void set_node(Heap *heap, size_t idx, HeapNode node)
+{
+    heap->nodes[idx] = node;
+    heap->positions[node.slot] = (uint32_t)idx;
+
+    STATS_COUNT(heap, moves, 1);
+}
+
+/**
+ * @brief Compara dois nós da heap (ver precedes), contando a comparação.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param a Primeiro nó.
+ * @param b Segundo nó.
+ * @return true se `a` sai antes de `b`, false caso contrário.
+ */
+static inline bool compare(Heap *heap, HeapNode a, HeapNode b)
+{
+    STATS_COUNT(heap, comparisons, 1);
+
+    return precedes(a, b);
+}
+
+/**
+ * @brief Sobe um voo na heap até que a propriedade de Max-Heap seja satisfeita.
+ *
+ * O nó é retirado da posição, deixando um "buraco" que sobe enquanto o nó
+ * preceder o pai (cada pai desce uma posição), e é gravado uma única vez no
+ * destino final.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param idx Posição do voo a ser ajustado.
+ */
+static void sift_up(Heap *heap, size_t idx)
+{
+    HeapNode node = heap->nodes[idx];
+    size_t levels = 0;
+
+    for (; idx > 0 && compare(heap, node, heap->nodes[parent(idx)]); levels++)
+    {
+        // O pai desce para o buraco
+        set_node(heap, idx, heap->nodes[parent(idx)]);
+        idx = parent(idx);
+    }
+
+    set_node(heap, idx, node);
+    STATS_SAMPLE(heap, depth, levels);
+}
+
+#if HEAP_BOTTOM_UP
+/**
+ * @brief Desce um buraco até uma folha pelo caminho dos maiores filhos.
+ *
+ * Variante de baixo para cima (Floyd/Wegener) da remoção: o maior filho
+ * sobe para o buraco a cada nível, sem comparar com o nó que ocupará a
+ * posição, pois o último nó da heap quase sempre volta ao fundo. Cada nível
+ * custa HEAP_ARITY - 1 comparações em vez de HEAP_ARITY.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param idx Posição do buraco.
+ * @return size_t Posição final do buraco (uma folha).
+ */
+static size_t sift_hole_down(Heap *heap, size_t idx)
+{
+    size_t first;
+    size_t levels = 0;
+
+    for (; (first = first_child(idx)) < heap->size; levels++)
+    {
+        size_t last = first + HEAP_ARITY;
+        size_t largest = first;
+
+        if (last > heap->size)
+            last = heap->size;
+
+        for (size_t child = first + 1; child < last; child++)
+            if (compare(heap, heap->nodes[child], heap->nodes[largest]))
+                largest = child;
+
+        set_node(heap, idx, heap->nodes[largest]);
+        idx = largest;
+    }
+
+    STATS_SAMPLE(heap, depth, levels);
+
+    return idx;
+}
+#endif
+
+/**
+ * @brief Guarda um voo em um slot livre e o acrescenta à estrutura.
+ *
+ * Na heap binária, o nó é anexado ao final sem ajuste; nos baldes, o voo
+ * vai para o fim do balde de sua prioridade; na heap de pareamento, é unido
+ * à raiz. A heap deve ter espaço para mais um voo.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param flight O voo a ser guardado.
+ */
+static void place(Heap *heap, const Flight *flight)
+{
+    uint32_t slot = heap->free_slots[heap->capacity - heap->size - 1];
+
+    heap->flights[slot] = *flight;
+    index_set(heap, flight->id, slot);
+
+    switch (heap->engine)
+    {
+    case ENGINE_BUCKET:
+        buckets_push(heap->buckets, slot, flight->priority);
+        break;
+    case ENGINE_PAIRING:
+        pairing_push(heap->pairing, slot, flight->priority, heap->arrivals++);
+        break;
+    default:
+        heap->nodes[heap->size].priority = flight->priority;
+        heap->nodes[heap->size].slot = slot;
+        heap->nodes[heap->size].arrival = heap->arrivals++;
+        heap->positions[slot] = (uint32_t)heap->size;
+        break;
+    }
+
+    heap->size++;
+}
+
+/**
+ * @brief Insere um voo na heap.
+ *
+ * Insere o voo na heap de forma que a propriedade de Max-Heap seja mantida.
+ * Caso a heap esteja cheia, sua capacidade é dobrada (custo amortizado O(1)
+ * por inserção). Se a realocação falhar ou já existir um voo com o mesmo
+ * código, a inserção não é realizada.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param flight O voo a ser inserido.
+ * @return true se o voo foi inserido, false caso contrário.
+ */
+bool insert(Heap *heap, Flight flight)
+{
+    STATS_BEGIN(heap, STATS_INSERT);
+
+    // Os códigos são únicos e indexam a heap
+    if (find_flight(heap, flight.id) != NULL)
+    {
+        char id[MAX_LEN];
+
+        fprintf(stderr, "Ja existe um voo com o ID %s.\n", unpack_id(flight.id, id));
+        STATS_CANCEL(heap);
+        return false;
+    }
+
+    // Dobra a capacidade caso a heap esteja cheia
+    if (heap->size == heap->capacity && !resize(heap, heap->capacity * 2))
+    {
+        fprintf(stderr, "Memoria insuficiente para inserir o voo.\n");
+        STATS_CANCEL(heap);
+        return false; // Se não for possível crescer, não insere o elemento
+    }
+
+    // Guarda o voo em um slot livre e adiciona seu nó ao final da heap
+    place(heap, &flight);
+
+    // Ajusta a posição do voo para manter a propriedade de Max-Heap
+    if (heap->engine == ENGINE_BINARY)
+        sift_up(heap, heap->size - 1);
+
+    STATS_END(heap);
+
+    journal_record(heap->journal, JOURNAL_INSERT, &flight);
+    trace_record(heap->trace, TRACE_INSERT, &flight, 0);
+
+    return true;
+}
+
+/**
+ * @brief Anexa um voo ao final da heap sem ajustá-lo.
+ *
+ * Usada na carga em massa: a propriedade de Max-Heap só é restaurada depois,
+ * por restore_heap. Voos com código repetido não são anexados.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param flight O voo a ser anexado.
+ * @return true se o voo foi anexado, false caso contrário.
+ */
+static bool append(Heap *heap, Flight flight)
+{
+    if (find_flight(heap, flight.id) != NULL)
+    {
+        char id[MAX_LEN];
+
+        fprintf(stderr, "Ja existe um voo com o ID %s.\n", unpack_id(flight.id, id));
+        return false;
+    }
+
+    if (heap->size == heap->capacity && !resize(heap, heap->capacity * 2))
+    {
+        fprintf(stderr, "Memoria insuficiente para inserir o voo.\n");
+        return false;
+    }
+
+    place(heap, &flight);
+
+    journal_record(heap->journal, JOURNAL_INSERT, &flight);
+
+    return true;
+}
+
+/**
+ * @brief Restaura a propriedade de Max-Heap após uma carga em massa.
+ *
+ * As posições anteriores a `first` já formam uma heap válida e as demais
+ * foram anexadas por append. Quando os voos anexados são muitos em relação
+ * aos existentes (m * log n > n), a heap inteira é reconstruída de baixo para
+ * cima em O(n + m); caso contrário, cada voo anexado sobe individualmente em
+ * O(m log n). Nos baldes e na heap de pareamento, não há o que restaurar.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param first Posição do primeiro voo anexado.
+ */
+static void restore_heap(Heap *heap, size_t first)
+{
+    size_t added = heap->size - first;
+    size_t depth = 0;
+
+    // Os baldes e a heap de pareamento já estão em ordem
+    if (heap->engine != ENGINE_BINARY)
+        return;
+
+    for (size_t n = heap->size; n > 1; n /= HEAP_ARITY)
+        depth++;
+
+    if (added * depth > first)
+        build_heap(heap);
+    else
+        for (size_t i = first; i < heap->size; i++)
+            sift_up(heap, i);
+}
+
+/**
+ * @brief Desce um nó na heap até que a propriedade de Max-Heap seja satisfeita.
+ *
+ * Cada nó tem até HEAP_ARITY filhos, em posições consecutivas. O nó desce
+ * de forma iterativa, como um buraco ocupado pelo maior filho a cada nível,
+ * e é gravado uma única vez no destino final.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param idx Posição do nó a ser ajustado.
+ */
+static void sift_down(Heap *heap, size_t idx)
+{
+    HeapNode node = heap->nodes[idx];
+    size_t first;
+    size_t levels = 0;
+
+    for (; (first = first_child(idx)) < heap->size; levels++)
+    {
+        size_t last = first + HEAP_ARITY;
+        size_t largest = first;
+
+        if (last > heap->size)
+            last = heap->size;
+
+        // Localiza o maior dos filhos existentes
+        for (size_t child = first + 1; child < last; child++)
+            if (compare(heap, heap->nodes[child], heap->nodes[largest]))
+                largest = child;
+
+        // Para quando nenhum filho é maior que o nó
+        if (!compare(heap, heap->nodes[largest], node))
+            break;
+
+        // O maior filho sobe para o buraco
+        set_node(heap, idx, heap->nodes[largest]);
+        idx = largest;
+    }
+
+    set_node(heap, idx, node);
+    STATS_SAMPLE(heap, depth, levels);
+}
+
+/**
+ * @brief Restaura a propriedade da Max-Heap.
+ *
+ * A função heapify ajusta a heap para garantir que o maior elemento
+ * esteja na raiz e que a propriedade de Max-Heap seja mantida, descendo o
+ * nó da posição `idx` (ver sift_down).
+ *
+ * @param heap Ponteiro para a heap.
+ * @param idx O índice a partir do qual o ajuste da heap será feito.
+ */
+void heapify(Heap *heap, size_t idx)
+{
+    STATS_BEGIN(heap, STATS_HEAPIFY);
+
+    sift_down(heap, idx);
+
+    STATS_END(heap);
+}
+
+/**
+ * @brief Remove um nó de uma posição da heap binária.
+ *
+ * O último nó ocupa a posição liberada e é ajustado para cima ou para
+ * baixo, conforme sua prioridade, em O(log n). Com HEAP_BOTTOM_UP, o buraco
+ * desce primeiro até uma folha (ver sift_hole_down) e o último nó sobe a
+ * partir dela, o que economiza comparações porque ele raramente sobe muito.
+ *
+ * @param heap Ponteiro para a heap (com o tamanho já decrementado).
+ * @param idx Posição do nó a ser removido.
+ */
+static void remove_node(Heap *heap, size_t idx)
+{
+    // O nó removido era o último
+    if (idx == heap->size)
+        return;
+
+#if HEAP_BOTTOM_UP
+    // Leva o buraco até uma folha e sobe o último nó a partir dela
+    idx = sift_hole_down(heap, idx);
+    set_node(heap, idx, heap->nodes[heap->size]);
+    sift_up(heap, idx);
+#else
+    set_node(heap, idx, heap->nodes[heap->size]);
+
+    // Restaura a propriedade de Max-Heap
+    if (idx > 0 && compare(heap, heap->nodes[idx], heap->nodes[parent(idx)]))
+        sift_up(heap, idx);
+    else
+        sift_down(heap, idx);
+#endif
+}
+
+/**
+ * @brief Remove um voo da heap.
+ *
+ * O voo sai do índice e da estrutura e seu slot volta à pilha de livres.
+ * Quando a ocupação cai para um quarto da capacidade, os vetores são
+ * reduzidos pela metade.
+ *
+ * @param heap Ponteiro para a heap (não vazia).
+ * @param slot Slot do voo a ser removido.
+ */
+static void detach_slot(Heap *heap, uint32_t slot)
+{
+    index_remove(heap, heap->flights[slot].id);
+
+    // Devolve o slot à pilha de livres e decrementa o tamanho da heap
+    heap->free_slots[heap->capacity - heap->size] = slot;
+    heap->size--;
+
+    switch (heap->engine)
+    {
+    case ENGINE_BUCKET:
+        buckets_remove(heap->buckets, slot, heap->flights[slot].priority);
+        break;
+    case ENGINE_PAIRING:
+        pairing_remove(heap->pairing, slot);
+        break;
+    default:
+        remove_node(heap, heap->positions[slot]);
+        break;
+    }
+}
+
+/**
+ * @brief Reduz os vetores da heap quando ela esvazia.
+ *
+ * A capacidade é dividida por 2 enquanto a heap ocupar até um quarto dela,
+ * com uma única realocação. A falha de realocação não é um erro.
+ *
+ * @param heap Ponteiro para a heap.
+ */
+static void shrink(Heap *heap)
+{
+    size_t capacity = heap->capacity;
+
+    while (capacity > INITIAL_CAPACITY && heap->size <= capacity / 4)
+        capacity /= 2;
+
+    if (capacity != heap->capacity)
+        resize(heap, capacity);
+}
+
+/**
+ * @brief Remove o voo de um slot e encolhe a heap se necessário.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param slot Slot do voo.
+ */
+static void remove_slot(Heap *heap, uint32_t slot)
+{
+    detach_slot(heap, slot);
+    shrink(heap);
+}
+
+/**
+ * @brief Obtém o slot do voo de maior prioridade.
+ *
+ * @param heap Ponteiro para a heap (não vazia).
+ * @return uint32_t Slot do voo.
+ */
+static uint32_t top_slot(Heap *heap)
+{
+    switch (heap->engine)
+    {
+    case ENGINE_BUCKET:
+        return buckets_first(heap->buckets);
+    case ENGINE_PAIRING:
+        return pairing_first(heap->pairing);
+    default:
+        return heap->nodes[0].slot;
+    }
+}
+
+/**
+ * @brief Remove o voo com a maior prioridade (raiz da heap).
+ *
+ * A função remove a raiz (maior prioridade) da heap.
+ * Após a remoção, a heap é ajustada para manter a propriedade de Max-Heap.
+ *
+ * @param heap Ponteiro para a heap.
+ */
+void pop(Heap *heap)
+{
+    // Verifica se a heap está vazia
+    if (heap->size == 0)
+    {
+        fprintf(stderr, "Impossível remover elemento, a árvore está vazia.\n");
+        return;
+    }
+
+    STATS_BEGIN(heap, STATS_POP);
+
+    remove_slot(heap, top_slot(heap));
+
+    STATS_END(heap);
+
+    journal_record(heap->journal, JOURNAL_POP, NULL);
+    trace_record(heap->trace, TRACE_POP, NULL, 0);
+}
+
+/**
+ * @brief Remove os voos de maior prioridade, na ordem de despacho.
+ *
+ * Equivale a `k` chamadas de top e pop, mas a heap só é encolhida uma vez,
+ * no fim. Cada retirada é registrada no diário.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param k Quantidade máxima de voos.
+ * @param out Recebe os voos removidos (espaço para `k` voos).
+ * @return size_t Quantidade de voos removidos (o menor entre `k` e o tamanho da heap).
+ */
+size_t pop_k(Heap *heap, size_t k, Flight *out)
+{
+    size_t count = 0;
+
+    for (; count < k && heap->size > 0; count++)
+    {
+        STATS_BEGIN(heap, STATS_POP);
+
+        uint32_t slot = top_slot(heap);
+
+        out[count] = heap->flights[slot];
+        detach_slot(heap, slot);
+
+        STATS_END(heap);
+
+        journal_record(heap->journal, JOURNAL_POP, NULL);
+    }
+
+    shrink(heap);
+
+    trace_record(heap->trace, TRACE_POP_K, NULL, k);
+
+    return count;
+}
+
+/**
+ * @brief Obtém o voo no topo da heap.
+ * 
+ * Esta função retorna o voo que está no topo da heap (índice 0), sem removê-lo. 
+ * Se a heap estiver vazia, exibe uma mensagem de erro e retorna NULL.
+ * 
+ * @param heap Ponteiro para a estrutura da heap.
+ * 
+ * @return Ponteiro para o voo no topo da heap ou NULL se a heap estiver vazia.
+ */
+Flight* top(Heap* heap)
+{
+    if (heap->size == 0)
+    {
+        fprintf(stderr, "Nao ha elementos a serem consutados.\n");
+        return NULL;
+    }
+
+    trace_record(heap->trace, TRACE_TOP, NULL, 0);
+
+    return &heap->flights[top_slot(heap)];
+}
+
+/**
+ * @brief Percorre os voos da heap.
+ *
+ * Na heap binária, os voos são visitados na ordem dos nós; nos baldes, na
+ * ordem de despacho; na heap de pareamento, em pré-ordem. O percurso começa com `*cursor` igual a zero e não
+ * pode atravessar alterações da heap.
+ *
+ * @param heap Ponteiro para a estrutura da heap.
+ * @param cursor Posição do percurso, atualizada a cada chamada.
+ *
+ * @return Ponteiro para o próximo voo ou NULL no fim.
+ */
+Flight *next_flight(Heap *heap, size_t *cursor)
+{
+    uint32_t slot;
+
+    if (heap->size == 0)
+        return NULL;
+
+    if (heap->engine == ENGINE_BINARY)
+    {
+        if (*cursor >= heap->size)
+            return NULL;
+
+        slot = heap->nodes[(*cursor)++].slot;
+    }
+    else
+    {
+        // O cursor guarda o slot do último voo visitado mais um
+        if (*cursor == 0)
+            slot = top_slot(heap);
+        else if (heap->engine == ENGINE_BUCKET)
+            slot = buckets_next(heap->buckets, (uint32_t)(*cursor - 1), heap->flights[*cursor - 1].priority);
+        else
+            slot = pairing_next(heap->pairing, (uint32_t)(*cursor - 1));
+
+        // BUCKET_NONE e PAIRING_NONE indicam o fim
+        if (slot == UINT32_MAX)
+            return NULL;
+
+        *cursor = (size_t)slot + 1;
+    }
+
+    return &heap->flights[slot];
+}
+
+/**
+ * @brief Acrescenta um nó à fronteira de top_k.
+ *
+ * A fronteira é uma pequena heap binária de nós candidatos, ordenada por
+ * precedes e com capacidade dobrada quando enche.
+ *
+ * @param frontier Ponteiro para o vetor da fronteira.
+ * @param count Quantidade de nós, incrementada.
+ * @param capacity Capacidade do vetor, atualizada se ele crescer.
+ * @param node Nó a acrescentar.
+ * @return true se o nó foi acrescentado, false se a alocação falhar.
+ */
+static bool frontier_push(HeapNode **frontier, size_t *count, size_t *capacity, HeapNode node)
+{
+    if (*count == *capacity)
+    {
+        HeapNode *grown = (HeapNode *)realloc(*frontier, 2 * *capacity * sizeof(HeapNode));
+
+        if (grown == NULL)
+            return false;
+
+        *frontier = grown;
+        *capacity *= 2;
+    }
+
+    HeapNode *nodes = *frontier;
+    size_t hole = (*count)++;
+
+    for (; hole > 0 && precedes(node, nodes[(hole - 1) / 2]); hole = (hole - 1) / 2)
+        nodes[hole] = nodes[(hole - 1) / 2];
+
+    nodes[hole] = node;
+
+    return true;
+}
+
+/**
+ * @brief Retira o melhor nó da fronteira de top_k.
  *
- * @return Heap* Ponteiro para a heap inicializada ou NULL se a alocação falhar.
+ * @param frontier Nós da fronteira (não vazia).
+ * @param count Quantidade de nós, decrementada.
+ * @return HeapNode Nó que sai primeiro.
  */
-Heap *initialize()
+static HeapNode frontier_pop(HeapNode *frontier, size_t *count)
 {
-    // Aloca memória para a heap
-    Heap *heap = (Heap *)malloc(sizeof(Heap));
+    HeapNode best = frontier[0];
+    HeapNode last = frontier[--(*count)];
+    size_t hole = 0;
 
-    // Verifica se a alocação foi bem-sucedida
-    if (heap != NULL)
+    for (size_t child = 1; child < *count; hole = child, child = 2 * child + 1)
     {
-        // Inicializa o tamanho da heap como zero
-        heap->size = 0;
-        return heap;
+        if (child + 1 < *count && precedes(frontier[child + 1], frontier[child]))
+            child++;
+
+        if (!precedes(frontier[child], last))
+            break;
+
+        frontier[hole] = frontier[child];
     }
 
-    // Se a alocação falhar, retorna NULL
-    return NULL;
+    frontier[hole] = last;
+
+    return best;
 }
 
 /**
- * @brief Carrega os voos de um arquivo e insere na heap.
+ * @brief Copia os voos de maior prioridade, na ordem de despacho.
  *
- * Abre um arquivo especificado pelo caminho e lê os dados dos voos.
- * Para cada voo lido, calcula a prioridade e o insere na heap.
+ * A heap não é alterada. Nos baldes, os primeiros voos do percurso já estão
+ * na ordem de despacho. Nas demais estruturas, a busca parte da raiz e
+ * mantém uma fronteira com os filhos dos nós já copiados: na heap binária,
+ * em O(k log k); na heap de pareamento, o custo depende também da
+ * quantidade de filhos dos nós copiados.
  *
- * @param file_path Caminho do arquivo contendo os dados dos voos.
- * @param heap Ponteiro para a heap onde os voos serão armazenados.
+ * @param heap Ponteiro para a heap.
+ * @param k Quantidade máxima de voos.
+ * @param out Recebe os voos (espaço para `k` voos).
+ * @return size_t Quantidade de voos copiados (o menor entre `k` e o tamanho da heap).
  */
-bool load_flights(char *file_path, Heap *heap)
+size_t top_k(Heap *heap, size_t k, Flight *out)
 {
-    // Tenta abrir o arquivo para leitura
-    FILE *input_file = fopen(file_path, "r");
+    size_t cursor = 0;
+    size_t count = 0;
+
+    trace_record(heap->trace, TRACE_TOP_K, NULL, k);
+
+    if (k > heap->size)
+        k = heap->size;
 
-    // Se o arquivo não puder ser aberto, exibe uma mensagem de erro
-    if (!input_file)
+    if (k == 0)
+        return 0;
+
+    if (heap->engine == ENGINE_BUCKET)
     {
-        fprintf(stderr, "Unable to read file \"%s\": %s.\n", file_path, strerror(errno));
-        return false; // Retorna caso haja erro ao abrir o arquivo
+        for (; count < k; count++)
+            out[count] = *next_flight(heap, &cursor);
+
+        return count;
     }
 
-    // Buffer para armazenar uma linha lida do arquivo
-    char linha[512];
-    Flight flight; // Variável para armazenar os dados do voo
-    ushort operation;
+    // Na heap binária, cada nó copiado dá lugar a até HEAP_ARITY filhos
+    size_t capacity = heap->engine == ENGINE_BINARY ? k * (HEAP_ARITY - 1) + 1 : k + 1;
+    HeapNode *frontier = (HeapNode *)malloc(capacity * sizeof(HeapNode));
+    size_t pending = 0;
+    bool success = frontier != NULL;
+
+    if (success)
+    {
+        uint32_t root = top_slot(heap);
+        HeapNode node = {heap->flights[root].priority, root, arrival_of(heap, root)};
+
+        frontier_push(&frontier, &pending, &capacity, node);
+    }
 
-    // Lê o arquivo linha por linha
-    while (fgets(linha, sizeof(linha), input_file))
+    for (; success && count < k; count++)
     {
-        // Lê os dados do voo da linha
-        int success = sscanf(linha, "%99[^,],%hu,%hu,%hu,%hu",
-                             flight.id, &flight.fuel, &flight.time, &operation, &flight.emergency);
+        HeapNode node = frontier_pop(frontier, &pending);
 
-        // Converte o código da operação para o tipo correto
-        flight.operation = (Operation)operation;
+        out[count] = heap->flights[node.slot];
 
-        // Calcula a prioridade do voo
-        flight.priority = calculate_priority(flight);
+        if (heap->engine == ENGINE_BINARY)
+        {
+            size_t child = first_child(heap->positions[node.slot]);
 
-        // Se a linha foi lida com sucesso (5 campos), insere o voo na heap
-        if (success == 5)
-            insert(heap, flight);
+            for (size_t i = 0; success && i < HEAP_ARITY && child + i < heap->size; i++)
+                success = frontier_push(&frontier, &pending, &capacity, heap->nodes[child + i]);
+        }
+        else
+        {
+            for (uint32_t slot = pairing_child(heap->pairing, node.slot); success && slot != PAIRING_NONE;
+                 slot = pairing_sibling(heap->pairing, slot))
+            {
+                HeapNode child = {heap->flights[slot].priority, slot, pairing_arrival(heap->pairing, slot)};
+
+                success = frontier_push(&frontier, &pending, &capacity, child);
+            }
+        }
     }
 
-    // Fecha o arquivo após terminar a leitura
-    fclose(input_file);
+    free(frontier);
 
-    return true;
+    if (!success)
+    {
+        fprintf(stderr, "Memoria insuficiente para consultar a heap.\n");
+        return 0;
+    }
+
+    return count;
 }
 
 /**
- * @brief Calcula a prioridade de um voo.
+ * @brief Compara dois nós pela ordem de despacho, para ordená-los com qsort.
  *
- * A prioridade é calculada com base no combustível, tempo de voo, operação e emergência.
+ * As chegadas devem ser relativas à mais antiga (ver dispatch_order), de
+ * modo que a comparação direta não sofra com a volta do contador.
  *
- * @param flight O voo cujo a prioridade será calculada.
- * @return unsigned Valor da prioridade calculada.
+ * @param a Ponteiro para o primeiro nó.
+ * @param b Ponteiro para o segundo nó.
+ * @return int Negativo, zero ou positivo se `a` sair antes, junto ou depois de `b`.
  */
-unsigned calculate_priority(Flight flight)
+static int compare_dispatch(const void *a, const void *b)
 {
-    return (1000 - flight.fuel) + (1440 - flight.time) + 500 * (flight.operation) + 500 * (flight.emergency);
+    const HeapNode *x = (const HeapNode *)a;
+    const HeapNode *y = (const HeapNode *)b;
+
+    if (x->priority != y->priority)
+        return (x->priority < y->priority) - (x->priority > y->priority);
+
+    return (x->arrival > y->arrival) - (x->arrival < y->arrival);
 }
 
 /**
- * @brief Insere um voo na heap.
+ * @brief Lista os slots dos voos na ordem de despacho.
  *
- * Insere o voo na heap de forma que a propriedade de Max-Heap seja mantida.
- * Caso a heap esteja cheia, a inserção não é realizada.
+ * A heap não é alterada. Nos baldes, o percurso já está na ordem de
+ * despacho; nas demais estruturas, os nós são copiados e ordenados, em
+ * O(n log n). Gravar ou registrar os voos nessa ordem preserva os
+ * desempates entre prioridades iguais quando eles são lidos de volta como
+ * chegadas sucessivas. Um vetor em ordem de despacho é também uma heap
+ * válida para qualquer aridade.
  *
  * @param heap Ponteiro para a heap.
- * @param flight O voo a ser inserido.
+ * @return uint32_t* Vetor com heap->size slots (alocado com malloc) ou NULL se a alocação falhar.
  */
-void insert(Heap *heap, Flight flight)
+uint32_t *dispatch_order(Heap *heap)
 {
-    // Verifica se a heap atingiu a capacidade máxima
-    if (heap->size == MAX_CAPACITY)
+    size_t count = heap->size > 0 ? heap->size : 1;
+    uint32_t *order = (uint32_t *)malloc(count * sizeof(uint32_t));
+    size_t cursor = 0;
+    Flight *flight;
+
+    if (order == NULL)
+        return NULL;
+
+    if (heap->engine == ENGINE_BUCKET)
     {
-        fprintf(stderr, "A capacidade máxima para voos foi atingida.\n");
-        return; // Se a heap estiver cheia, não insere mais elementos
-    }
+        for (size_t i = 0; (flight = next_flight(heap, &cursor)) != NULL; i++)
+            order[i] = (uint32_t)(flight - heap->flights);
 
-    // Adiciona o voo ao final da heap
-    heap->data[heap->size] = flight;
+        return order;
+    }
 
-    // Índice do último elemento inserido
-    size_t idx = heap->size;
+    HeapNode *nodes = (HeapNode *)malloc(count * sizeof(HeapNode));
+    uint32_t oldest = oldest_arrival(heap);
 
-    // Incrementa o tamanho da heap
-    heap->size++;
+    if (nodes == NULL)
+    {
+        free(order);
+        return NULL;
+    }
 
-    // Ajusta a posição do voo para manter a propriedade de Max-Heap
-    while (idx > 0 && heap->data[idx].priority > heap->data[(idx - 1) / 2].priority)
+    for (size_t i = 0; (flight = next_flight(heap, &cursor)) != NULL; i++)
     {
-        // Troca o voo com o pai, se necessário
-        swap(&heap->data[idx], &heap->data[(idx - 1) / 2]);
-        // Atualiza o índice do voo
-        idx = (idx - 1) / 2;
+        uint32_t slot = (uint32_t)(flight - heap->flights);
+
+        nodes[i].priority = flight->priority;
+        nodes[i].slot = slot;
+        nodes[i].arrival = arrival_of(heap, slot) - oldest;
     }
+
+    qsort(nodes, heap->size, sizeof(HeapNode), compare_dispatch);
+
+    for (size_t i = 0; i < heap->size; i++)
+        order[i] = nodes[i].slot;
+
+    free(nodes);
+
+    return order;
 }
 
 /**
- * @brief Troca dois elementos de voo.
+ * @brief Busca um voo pelo seu código.
  *
- * Troca os valores de dois voos na heap.
+ * Consulta o índice de IDs em O(1) esperado. O ponteiro retornado aponta
+ * para o repositório de voos e só é válido até a próxima alteração da heap.
  *
- * @param a Ponteiro para o primeiro voo.
- * @param b Ponteiro para o segundo voo.
+ * @param heap Ponteiro para a estrutura da heap.
+ * @param flight_id Código empacotado do voo procurado (ver pack_id).
+ *
+ * @return Ponteiro para o voo ou NULL se não houver voo com o código.
  */
-void swap(Flight *a, Flight *b)
+Flight *find_flight(Heap *heap, FlightKey flight_id)
 {
-    // Armazena temporariamente o valor de um voo
-    Flight temp = *a;
+    // Códigos inválidos (0) nunca estão no índice
+    if (flight_id == 0)
+        return NULL;
 
-    // Atribui o valor do segundo voo ao primeiro
-    *a = *b;
+    IndexEntry *entry = &heap->index[index_slot(heap, flight_id)];
 
-    // Atribui o valor armazenado do primeiro voo ao segundo
-    *b = temp;
+    if (entry->hash == 0)
+        return NULL;
+
+    return &heap->flights[entry->slot];
 }
 
 /**
- * @brief Restaura a propriedade da Max-Heap.
+ * @brief Atualiza os dados de um voo na própria posição da heap.
  *
- * A função heapify ajusta a heap para garantir que o maior elemento
- * esteja na raiz e que a propriedade de Max-Heap seja mantida.
+ * Copia combustível, tempo, operação e emergência de `fields` para o voo
+ * identificado por `flight_id` (o código em `fields` é ignorado), recalcula
+ * sua prioridade e o desloca para cima ou para baixo em O(log n), sem
+ * removê-lo nem reinseri-lo (nos baldes, muda de balde em O(1); na heap de
+ * pareamento, sai e volta em O(log n) amortizado). Se a
+ * prioridade mudar, o voo passa a ser o último a chegar nela.
  *
- * @param heap Ponteiro para a heap.
- * @param idx O índice a partir do qual o ajuste da heap será feito.
+ * @param heap Ponteiro para a estrutura da heap.
+ * @param flight_id Código empacotado do voo a ser atualizado.
+ * @param fields Novos dados do voo.
+ *
+ * @return true se o voo foi atualizado, false se não houver voo com o código.
  */
-void heapify(Heap *heap, size_t idx)
+bool update_flight(Heap *heap, FlightKey flight_id, Flight fields)
 {
-    // Índices dos filhos esquerdo e direito
-    size_t largest, left, right;
+    STATS_BEGIN(heap, STATS_UPDATE);
+
+    Flight *flight = find_flight(heap, flight_id);
+
+    if (flight == NULL)
+    {
+        STATS_CANCEL(heap);
+        return false;
+    }
+
+    uint32_t slot = (uint32_t)(flight - heap->flights);
+    ushort old_priority = flight->priority;
+
+    flight->fuel = fields.fuel;
+    flight->time = fields.time;
+    flight->operation = fields.operation;
+    flight->emergency = fields.emergency;
+    flight->priority = calculate_priority(*flight);
 
-    largest = idx;
-    left    = 2 * idx + 1;
-    right   = 2 * idx + 2;
+    journal_record(heap->journal, JOURNAL_UPDATE, flight);
+    trace_record(heap->trace, TRACE_UPDATE, flight, 0);
 
-    // Verifica se o filho esquerdo existe e é maior que o nó atual
-    if (left < heap->size && heap->data[left].priority > heap->data[largest].priority)
-        largest = left;
+    if (flight->priority == old_priority)
+    {
+        STATS_END(heap);
+        return true;
+    }
 
-    // Verifica se o filho direito existe e é maior que o nó atual
-    if (right < heap->size && heap->data[right].priority > heap->data[largest].priority)
-        largest = right;
+    if (heap->engine == ENGINE_BUCKET)
+    {
+        buckets_remove(heap->buckets, slot, old_priority);
+        buckets_push(heap->buckets, slot, flight->priority);
+        STATS_END(heap);
+        return true;
+    }
 
-    // Se o maior não for o índice atual, troca os elementos e chama recursivamente heapify
-    if (largest != idx)
+    if (heap->engine == ENGINE_PAIRING)
     {
-        // Troca o elemento atual com o maior dos filhos
-        swap(&heap->data[idx], &heap->data[largest]);
-        // Chama heapify recursivamente para o filho trocado
-        heapify(heap, largest);
+        pairing_remove(heap->pairing, slot);
+        pairing_push(heap->pairing, slot, flight->priority, heap->arrivals++);
+        STATS_END(heap);
+        return true;
     }
+
+    size_t idx = heap->positions[slot];
+
+    heap->nodes[idx].priority = flight->priority;
+    heap->nodes[idx].arrival = heap->arrivals++;
+
+    // Restaura a propriedade de Max-Heap na direção em que a prioridade mudou
+    if (flight->priority > old_priority)
+        sift_up(heap, idx);
+    else
+        sift_down(heap, idx);
+
+    STATS_END(heap);
+
+    return true;
 }
 
 /**
- * @brief Remove o voo com a maior prioridade (raiz da heap).
- *
- * A função remove a raiz (maior prioridade) da heap e retorna o voo removido.
- * Após a remoção, a heap é ajustada para manter a propriedade de Max-Heap.
- *
- * @param heap Ponteiro para a heap.
+ * @brief Remove um voo da heap.
+ * 
+ * Esta função remove o voo identificado pelo `flight_id` da heap. Se o `flight_id` 
+ * for 0, ela remove o voo do topo da heap. O voo é localizado pelo índice
+ * de IDs e sua posição é ocupada pelo último voo, que é reposicionado em
+ * O(log n), preservando a propriedade de Max-Heap (nos baldes, o voo apenas
+ * sai do seu balde, em O(1); na heap de pareamento, seus filhos tomam o seu
+ * lugar, em O(log n) amortizado).
+ * 
+ * @param heap Ponteiro para a estrutura da heap.
+ * @param flight_id Código empacotado do voo a ser removido. Se 0, remove o topo da heap.
+ * @param removed Recebe uma cópia do voo removido (pode ser NULL).
+ * 
+ * @return true se o voo foi removido, false se a heap estiver vazia ou o voo não existir.
  */
-void pop(Heap *heap)
+bool excluir(Heap *heap, FlightKey flight_id, Flight *removed)
 {
     // Verifica se a heap está vazia
     if (heap->size == 0)
     {
         fprintf(stderr, "Impossível remover elemento, a árvore está vazia.\n");
-        return; // Se a heap estiver vazia, retorna NULL
+        return false;
     }
 
-    // Ponteiro para o voo que será removido (raiz da heap)
-    Flight *flight = &heap->data[0];
+    STATS_BEGIN(heap, STATS_EXCLUIR);
 
-    // Substitui a raiz pelo último elemento
-    heap->data[0] = heap->data[heap->size - 1];
-    // Decrementa o tamanho da heap
-    heap->size--;
+    Flight *flight = flight_id == 0 ? &heap->flights[top_slot(heap)] : find_flight(heap, flight_id);
 
-    // Restaura a propriedade de Max-Heap
-    heapify(heap, 0);
+    if (flight == NULL)
+    {
+        STATS_CANCEL(heap);
+        return false;
+    }
+
+    // Registra a operação enquanto o voo ainda ocupa sua posição
+    if (flight_id == 0)
+    {
+        journal_record(heap->journal, JOURNAL_POP, NULL);
+        trace_record(heap->trace, TRACE_POP, NULL, 0);
+    }
+    else
+    {
+        journal_record(heap->journal, JOURNAL_DELETE, flight);
+        trace_record(heap->trace, TRACE_DELETE, flight, 0);
+    }
+
+    // Copia o voo antes que sua posição seja reaproveitada
+    if (removed != NULL)
+        *removed = *flight;
+
+    remove_slot(heap, (uint32_t)(flight - heap->flights));
+
+    STATS_END(heap);
+
+    return true;
 }
 
 /**
- * @brief Obtém o voo no topo da heap.
- * 
- * Esta função retorna o voo que está no topo da heap (índice 0), sem removê-lo. 
- * Se a heap estiver vazia, exibe uma mensagem de erro e retorna NULL.
- * 
- * @param heap Ponteiro para a estrutura da heap.
- * 
- * @return Ponteiro para o voo no topo da heap ou NULL se a heap estiver vazia.
+ * @brief Constrói a heap a partir de um array de dados.
+ *
+ * Este processo é chamado de "construção de heap" e é necessário para garantir que a
+ * propriedade de Max-Heap seja mantida após a construção de uma heap a partir de dados desordenados.
+ *
+ * O custo total é O(n). Nos baldes e na heap de pareamento, não há o que
+ * construir.
+ *
+ * @param heap Ponteiro para a heap a ser construída.
  */
-Flight* top(Heap* heap)
+void build_heap(Heap *heap)
 {
-    if (heap->size == 0)
+    // Heaps com menos de dois elementos e as demais estruturas já são válidas
+    if (heap->size < 2 || heap->engine != ENGINE_BINARY)
+        return;
+
+    // Aplica heapify de baixo para cima, a partir do último nó não-folha
+    for (size_t i = parent(heap->size - 1) + 1; i-- > 0;)
+        sift_down(heap, i);
+}
+
+/**
+ * @brief Esvazia a heap sem liberar seus vetores.
+ *
+ * Depois de esvaziada, a heap é reduzida à capacidade inicial (a falha não
+ * é um erro).
+ *
+ * @param heap Ponteiro para a heap.
+ */
+static void empty(Heap *heap)
+{
+    heap->size = 0;
+    heap->arrivals = 0;
+    memset(heap->index, 0, heap->index_capacity * sizeof(IndexEntry));
+
+    for (size_t i = 0; i < heap->capacity; i++)
+        heap->free_slots[i] = (uint32_t)(heap->capacity - 1 - i);
+
+    if (heap->engine == ENGINE_BUCKET)
+        buckets_clear(heap->buckets);
+    else if (heap->engine == ENGINE_PAIRING)
+        pairing_clear(heap->pairing);
+
+    resize(heap, INITIAL_CAPACITY);
+}
+
+/**
+ * @brief Compara dois slots, para ordená-los com qsort.
+ *
+ * @param a Ponteiro para o primeiro slot.
+ * @param b Ponteiro para o segundo slot.
+ * @return int Negativo, zero ou positivo se `a` for menor, igual ou maior que `b`.
+ */
+static int compare_slots(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Remove de uma heap os voos cujos códigos já estão em outra.
+ *
+ * Os voos são informados na ordem dos slots, que numa heap recém-importada
+ * é a ordem do arquivo, qualquer que seja a estrutura.
+ *
+ * @param dst Heap de referência.
+ * @param src Heap da qual os voos repetidos são removidos.
+ * @return true se os voos foram removidos, false se a alocação falhar.
+ */
+static bool discard_duplicates(Heap *dst, Heap *src)
+{
+    size_t count = 0;
+    size_t cursor = 0;
+    Flight *flight;
+
+    while ((flight = next_flight(src, &cursor)) != NULL)
+        if (find_flight(dst, flight->id) != NULL)
+            count++;
+
+    if (count == 0)
+        return true;
+
+    // Os códigos são copiados porque cada remoção pode compactar a heap
+    uint32_t *slots = (uint32_t *)malloc(count * sizeof(uint32_t));
+    FlightKey *ids = (FlightKey *)malloc(count * sizeof(FlightKey));
+    char id[MAX_LEN];
+
+    if (slots == NULL || ids == NULL)
     {
-        fprintf(stderr, "Nao ha elementos a serem consutados.\n");
-        return NULL;
+        free(slots);
+        free(ids);
+        return false;
     }
 
-    return &heap->data[0];
+    count = 0;
+    cursor = 0;
+
+    while ((flight = next_flight(src, &cursor)) != NULL)
+        if (find_flight(dst, flight->id) != NULL)
+            slots[count++] = (uint32_t)(flight - src->flights);
+
+    qsort(slots, count, sizeof(uint32_t), compare_slots);
+
+    for (size_t i = 0; i < count; i++)
+        ids[i] = src->flights[slots[i]].id;
+
+    free(slots);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        fprintf(stderr, "Ja existe um voo com o ID %s.\n", unpack_id(ids[i], id));
+        remove_slot(src, (uint32_t)(find_flight(src, ids[i]) - src->flights));
+    }
+
+    free(ids);
+
+    return true;
 }
 
 /**
- * @brief Remove um voo da heap.
- * 
- * Esta função remove o voo identificado pelo `flight_id` da heap. Se o `flight_id` 
- * for NULL, ela remove o voo do topo da heap. Caso a heap esteja vazia ou o 
- * voo com o `flight_id` não seja encontrado, a função retorna NULL.
- * Após remover o voo, a função restaura a propriedade de Max-Heap, garantindo
- * que a estrutura de heap continue válida.
- * 
- * @param heap Ponteiro para a estrutura da heap.
- * @param flight_id Identificador do voo a ser removido. Se NULL, remove o topo da heap.
- * 
- * @return Ponteiro para o voo removido ou NULL se não for possível remover o voo.
+ * @brief Troca o conteúdo de duas heaps, mantendo o diário, o rastro e as
+ * estatísticas de cada uma.
+ *
+ * @param a Primeira heap.
+ * @param b Segunda heap.
  */
-Flight *excluir(Heap *heap, char flight_id[MAX_LEN])
+static void swap_contents(Heap *a, Heap *b)
 {
-    // Verifica se a heap está vazia
-    if (heap->size == 0)
+    struct Journal *a_journal = a->journal;
+    struct Journal *b_journal = b->journal;
+    struct Trace *a_trace = a->trace;
+    struct Trace *b_trace = b->trace;
+    Heap temp = *a;
+
+    *a = *b;
+    *b = temp;
+    a->journal = a_journal;
+    b->journal = b_journal;
+    a->trace = a_trace;
+    b->trace = b_trace;
+#if HEAP_STATS
+    HeapStats stats = a->stats;
+
+    a->stats = b->stats;
+    b->stats = stats;
+#endif
+}
+
+/**
+ * @brief Retorna a chegada mais antiga entre os voos de uma heap.
+ *
+ * Os baldes não guardam a ordem de chegada; neles, assim como na heap
+ * vazia, o valor retornado é o próximo valor do contador.
+ *
+ * @param heap Ponteiro para a heap.
+ * @return uint32_t Chegada mais antiga.
+ */
+static uint32_t oldest_arrival(Heap *heap)
+{
+    uint32_t oldest = heap->arrivals;
+    size_t cursor = 0;
+    Flight *flight;
+
+    if (heap->engine == ENGINE_BUCKET)
+        return oldest;
+
+    while ((flight = next_flight(heap, &cursor)) != NULL)
     {
-        fprintf(stderr, "Impossível remover elemento, a árvore está vazia.\n");
-        return NULL; // Se a heap estiver vazia, retorna NULL
+        uint32_t arrival = arrival_of(heap, (uint32_t)(flight - heap->flights));
+
+        if ((uint32_t)(oldest - arrival - 1) < UINT32_C(0x7FFFFFFF))
+            oldest = arrival;
     }
 
-    int index = -1;
+    return oldest;
+}
+
+/**
+ * @brief Copia os voos de uma heap para slots livres de outra e a esvazia.
+ *
+ * Os voos copiados mantêm entre si a ordem de chegada e chegam depois dos
+ * que já estão no destino ou, se `before` for true, antes deles (o que os
+ * baldes não suportam). A ordem é restaurada de uma vez: na heap de
+ * pareamento, com uma única união de raízes; na heap binária, por
+ * restore_heap; nos baldes, cada voo vai para o fim do seu balde.
+ *
+ * @param dst Heap de destino, com capacidade para os voos das duas.
+ * @param src Heap de origem.
+ * @param slots Vetor com src->capacity posições (usado só na heap de pareamento).
+ * @param before true se os voos copiados chegam antes dos do destino.
+ */
+static void transfer(Heap *dst, Heap *src, uint32_t *slots, bool before)
+{
+    uint32_t oldest = oldest_arrival(src);
+    uint32_t offset;
 
-    if (flight_id == NULL)
-        index = 0;
+    // As chegadas copiadas passam a vir logo depois (ou logo antes) das do destino
+    if (before)
+        offset = oldest_arrival(dst) - src->arrivals;
     else
     {
-        for (int i = 0; i < heap->size; i++)
-            if (strcmp(heap->data[i].id, flight_id) == 0)
-                index = i;
-
-        if (index == -1)
-            return NULL;
+        offset = dst->arrivals - oldest;
+        dst->arrivals += src->arrivals - oldest;
     }
 
-    // Ponteiro para o voo que será removido (raiz da heap)
-    Flight *flight = &heap->data[index];
+    size_t first = dst->size;
+    size_t cursor = 0;
+    Flight *flight;
+
+    while ((flight = next_flight(src, &cursor)) != NULL)
+    {
+        uint32_t from = (uint32_t)(flight - src->flights);
+        uint32_t slot = dst->free_slots[dst->capacity - dst->size - 1];
+
+        dst->flights[slot] = *flight;
+        index_set(dst, flight->id, slot);
+
+        switch (dst->engine)
+        {
+        case ENGINE_BUCKET:
+            buckets_push(dst->buckets, slot, flight->priority);
+            break;
+        case ENGINE_PAIRING:
+            slots[from] = slot;
+            break;
+        default:
+            dst->nodes[dst->size].priority = flight->priority;
+            dst->nodes[dst->size].slot = slot;
+            dst->nodes[dst->size].arrival = arrival_of(src, from) + offset;
+            dst->positions[slot] = (uint32_t)dst->size;
+            break;
+        }
 
-    if (flight_id == NULL)
-        heap->data[0] = heap->data[heap->size - 1];
+        dst->size++;
+    }
+
+    if (dst->engine == ENGINE_PAIRING)
+        pairing_absorb(dst->pairing, src->pairing, slots, offset);
     else
-        for (int i = index; i < heap->size; i++)
-            heap->data[i] = heap->data[i + 1];
+        restore_heap(dst, first);
 
-    // Substitui a raiz pelo último elemento
-    // Decrementa o tamanho da heap
-    heap->size--;
+    empty(src);
+}
 
-    // Restaura a propriedade de Max-Heap
-    heapify(heap, index);
+/**
+ * @brief Transfere todas as aeronaves de uma heap para outra.
+ *
+ * As heaps devem usar a mesma estrutura. Voos da origem cujo código já está
+ * no destino são descartados, como em insert. Os demais chegam ao destino
+ * depois dos que já estavam lá, mantendo entre si a ordem de chegada, e são
+ * registrados no diário do destino na ordem de despacho (ver dispatch_order),
+ * que reproduz os mesmos desempates quando o diário é reaplicado. Só a menor
+ * das heaps é copiada, em O(m): se a origem for maior, as heaps trocam de
+ * conteúdo antes da cópia e os voos do destino são renumerados para chegar
+ * primeiro. Com o destino vazio, nada é copiado. Nos baldes, que não guardam
+ * a ordem de chegada, a origem é sempre copiada (salvo com o destino vazio).
+ * A origem termina vazia.
+ *
+ * @param dst Heap de destino.
+ * @param src Heap de origem.
+ * @return true se as heaps foram unidas, false se a alocação falhar.
+ */
+bool heap_merge(Heap *dst, Heap *src)
+{
+    if (dst->engine != src->engine)
+    {
+        fprintf(stderr, "Nao e possivel unir heaps de estruturas diferentes.\n");
+        return false;
+    }
+
+    if (!discard_duplicates(dst, src))
+    {
+        fprintf(stderr, "Memoria insuficiente para unir as heaps.\n");
+        return false;
+    }
+
+    bool swap = dst->size == 0 || (dst->engine != ENGINE_BUCKET && src->size > dst->size);
+    Heap *larger = swap ? src : dst;
+    Heap *smaller = swap ? dst : src;
+    uint32_t *slots = NULL;
+    uint32_t *order = NULL;
 
-    // Retorna o voo removido
-    return flight;
+    // A ordem de despacho é tirada depois de reserve, que pode compactar os slots da origem
+    if ((dst->engine == ENGINE_PAIRING &&
+         (slots = (uint32_t *)malloc(smaller->capacity * sizeof(uint32_t))) == NULL) ||
+        !reserve(larger, larger->size + smaller->size) ||
+        (dst->journal != NULL && (order = dispatch_order(src)) == NULL))
+    {
+        fprintf(stderr, "Memoria insuficiente para unir as heaps.\n");
+        free(slots);
+        free(order);
+        return false;
+    }
+
+    // Registra os voos da origem antes que as heaps troquem de conteúdo
+    for (size_t i = 0; order != NULL && i < src->size; i++)
+        journal_record(dst->journal, JOURNAL_INSERT, &src->flights[order[i]]);
+
+    free(order);
+
+    trace_record_heap(dst->trace, TRACE_MERGE, src);
+
+    if (swap)
+        swap_contents(dst, src);
+
+    transfer(dst, src, slots, swap);
+    free(slots);
+
+    return true;
 }
 
 /**
- * @brief Constrói a heap a partir de um array de dados.
+ * @brief Remove todas as aeronaves da heap.
  *
- * Este processo é chamado de "construção de heap" e é necessário para garantir que a
- * propriedade de Max-Heap seja mantida após a construção de uma heap a partir de dados desordenados.
+ * A heap volta à capacidade inicial. A remoção é registrada no diário
+ * (JOURNAL_CLEAR) e no rastro (como um estado vazio).
  *
- * @param heap Ponteiro para a heap a ser construída.
+ * @param heap Ponteiro para a heap.
  */
-void build_heap(Heap *heap)
+void clear_flights(Heap *heap)
+{
+    empty(heap);
+
+    journal_record(heap->journal, JOURNAL_CLEAR, NULL);
+    trace_record_heap(heap->trace, TRACE_STATE, heap);
+}
+
+/**
+ * @brief Substitui o conteúdo da heap por um vetor já organizado como heap.
+ *
+ * Em caso de sucesso, a heap passa a ser dona de `data`, que deve ter sido
+ * alocado com malloc, comportar `capacity` voos e já satisfazer a
+ * propriedade de Max-Heap, sem códigos repetidos. `data` passa a ser o
+ * repositório de voos (o voo i ocupa o slot i e o nó i) e os vetores
+ * anteriores são liberados; a estrutura e o índice de IDs são construídos
+ * em O(n), sem reordenar os voos. A ordem de chegada segue a ordem de
+ * `data`, que desempata prioridades iguais. No diário, a troca é registrada como JOURNAL_CLEAR seguido da
+ * inserção de cada voo na ordem de chegada, o que reproduz o mesmo estado
+ * (inclusive os desempates) na recuperação. Em caso de falha, a heap não é
+ * alterada.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param data Vetor de voos organizado como heap.
+ * @param size Quantidade de voos em `data`.
+ * @param capacity Quantidade de voos que cabem em `data` (>= size).
+ * @return true se os voos foram adotados, false se a alocação falhar.
+ */
+bool adopt_flights(Heap *heap, Flight *data, size_t size, size_t capacity)
 {
-    // Inicia a partir do último nó não-folha
-    size_t start_idx = heap->size / 2 - 1;
+    if (!install(heap, data, size, capacity, NULL))
+        return false;
 
-    // Aplica heapify de baixo para cima para ajustar todos os nós
-    for (int i = start_idx; i >= 0; i--)
-        heapify(heap, i);
+    heap->arrivals = (uint32_t)size;
+
+    if (heap->journal != NULL)
+    {
+        journal_record(heap->journal, JOURNAL_CLEAR, NULL);
+
+        for (size_t i = 0; i < size; i++)
+            journal_record(heap->journal, JOURNAL_INSERT, &heap->flights[i]);
+    }
+
+    trace_record_heap(heap->trace, TRACE_STATE, heap);
+
+    return true;
 }
 
 /**
  * @brief Libera a memória alocada para a heap.
  *
- * Libera a memória alocada para a heap e define o ponteiro da heap como NULL.
+ * Fecha o diário e o rastro associados (se houver), libera os vetores e a memória
+ * alocada para a heap e define o ponteiro da heap como NULL.
  *
  * @param heap Ponteiro para o ponteiro da heap a ser desalocada.
  */
 void deallocate(Heap **heap)
 {
+    // Grava as operações pendentes e fecha o diário e o rastro
+    journal_close(&(*heap)->journal);
+    trace_close(&(*heap)->trace);
+
+    // Libera a estrutura, o repositório de voos e o índice
+    free_arena((*heap)->nodes);
+    free((*heap)->positions);
+    buckets_destroy(&(*heap)->buckets);
+    pairing_destroy(&(*heap)->pairing);
+    free((*heap)->flights);
+    free((*heap)->free_slots);
+    free((*heap)->index);
     // Libera a memória alocada para a heap
     free(*heap);
     // Define o ponteiro para NULL após liberar a memória
@@ -4,6 +4,7 @@
 
 #include "handlers.h"
 #include "flight.h"
+#include "snapshot.h"
 
 #define HORIZONTAL_LINE_LENGTH 97
 #define ID_COLUMN_LENGTH 15
@@ -12,19 +13,105 @@
 #define OPERATION_COLUMN_LENGHT 15
 #define EMERGENCY_COLUMN_LENGTH 15
 #define PRIORITY_COLUMN_LENGTH 15
+#define NEXT_FLIGHTS 5
+#define TABLE_BUFFER_SIZE (1 << 20)
+
+// Buffer em que a tabela é montada antes de ser escrita.
+typedef struct
+{
+    char data[TABLE_BUFFER_SIZE]; //! Conteúdo ainda não escrito.
+    size_t length;                //! Quantidade de bytes ocupados.
+} TableBuffer;
+
+// Buffer da tabela, grande demais para a pilha.
+static TableBuffer table;
+
+/**
+ * @brief Escreve o conteúdo do buffer da tabela na saída padrão.
+ *
+ * O buffer é escrito com uma única chamada a fwrite e esvaziado.
+ */
+static void flush_table()
+{
+    fwrite(table.data, 1, table.length, stdout);
+    fflush(stdout);
+    table.length = 0;
+}
+
+/**
+ * @brief Acrescenta texto ao buffer da tabela.
+ *
+ * O buffer é escrito antes de encher (ver flush_table).
+ *
+ * @param text Texto a acrescentar.
+ * @param length Quantidade de bytes (no máximo TABLE_BUFFER_SIZE).
+ */
+static void append_table(const char *text, size_t length)
+{
+    if (table.length + length > TABLE_BUFFER_SIZE)
+        flush_table();
+
+    memcpy(table.data + table.length, text, length);
+    table.length += length;
+}
+
+/**
+ * @brief Acrescenta uma célula da tabela ao buffer.
+ *
+ * A célula é um espaço, o texto alinhado à esquerda em `width - 2`
+ * caracteres, um espaço e a barra que a fecha.
+ *
+ * @param text Texto da célula.
+ * @param width Largura da coluna.
+ */
+static void append_cell(const char *text, size_t width)
+{
+    char cell[64];
+    size_t length = strlen(text);
+
+    memset(cell, ' ', width);
+    memcpy(cell + 1, text, length);
+    cell[width] = '|';
+
+    append_table(cell, width + 1);
+}
+
+/**
+ * @brief Escreve um número, alinhado à esquerda, no início de uma célula.
+ *
+ * @param cell Primeiro caractere do conteúdo da célula.
+ * @param value Valor a escrever.
+ */
+static void write_number(char *cell, unsigned value)
+{
+    char digits[16];
+    size_t i = sizeof(digits);
+
+    do
+        digits[--i] = (char)('0' + value % 10);
+    while ((value /= 10) > 0);
+
+    memcpy(cell, digits + i, sizeof(digits) - i);
+}
 
 /**
  * @brief Desenha uma linha horizontal de caracteres '-'.
  *
- * Esta função imprime uma linha de caracteres '-' de comprimento
- * definido pela constante HORIZONTAL_LINE_LENGTH, seguida por uma
- * quebra de linha. Usada para separar seções na saída da tabela.
+ * Esta função acrescenta ao buffer da tabela uma linha de caracteres '-' de
+ * comprimento HORIZONTAL_LINE_LENGTH, seguida por uma quebra de linha. Usada
+ * para separar seções na saída da tabela.
  */
 static void draw_horizontal_line()
 {
-    for (size_t i = 0; i < HORIZONTAL_LINE_LENGTH; i++)
-        printf("-");
-    printf("\n");
+    static char line[HORIZONTAL_LINE_LENGTH + 1];
+
+    if (line[0] == '\0')
+    {
+        memset(line, '-', HORIZONTAL_LINE_LENGTH);
+        line[HORIZONTAL_LINE_LENGTH] = '\n';
+    }
+
+    append_table(line, sizeof(line));
 }
 
 /**
@@ -39,14 +126,14 @@ static void draw_table_header()
 {
     draw_horizontal_line();
 
-    printf("|");
-    printf(" %-*s | %-*s | %-*s | %-*s | %-*s | %-*s |\n",
-           ID_COLUMN_LENGTH - 2, "Id",
-           FUEL_COLUMN_LENGTH - 2, "Combustivel",
-           TIME_COLUMN_LENGTH - 2, "Tempo",
-           OPERATION_COLUMN_LENGHT - 2, "Operacao",
-           EMERGENCY_COLUMN_LENGTH - 2, "Emergencia",
-           PRIORITY_COLUMN_LENGTH - 2, "Prioridade");
+    append_table("|", 1);
+    append_cell("Id", ID_COLUMN_LENGTH);
+    append_cell("Combustivel", FUEL_COLUMN_LENGTH);
+    append_cell("Tempo", TIME_COLUMN_LENGTH);
+    append_cell("Operacao", OPERATION_COLUMN_LENGHT);
+    append_cell("Emergencia", EMERGENCY_COLUMN_LENGTH);
+    append_cell("Prioridade", PRIORITY_COLUMN_LENGTH);
+    append_table("\n", 1);
 
     draw_horizontal_line();
 }
@@ -54,25 +141,96 @@ static void draw_table_header()
 /**
  * @brief Desenha uma linha de voo na tabela.
  *
- * Esta função exibe uma linha de dados referente a um voo na tabela, com a
- * formatação correta de cada coluna. As informações mostradas incluem o ID do voo,
- * o combustível restante, o tempo de voo, a operação (decolagem ou pouso),
- * o estado de emergência e a prioridade do voo.
+ * Esta função acrescenta ao buffer da tabela uma linha de dados referente a
+ * um voo, com a formatação correta de cada coluna, seguida da linha
+ * horizontal. As informações mostradas incluem o ID do voo, o combustível
+ * restante, o tempo de voo, a operação (decolagem ou pouso), o estado de
+ * emergência e a prioridade do voo. As duas linhas partem de um modelo já
+ * formatado, no qual apenas os campos são escritos, sem printf.
  *
  * @param flight O voo a ser exibido.
  */
-static void draw_row(Flight flight)
+static void draw_row(const Flight *flight)
 {
-    printf("|");
-    printf(" %-*s | %-*u | %-*u | %-*s | %-*s | %-*u |\n",
-           ID_COLUMN_LENGTH - 2, flight.id,
-           FUEL_COLUMN_LENGTH - 2, flight.fuel,
-           TIME_COLUMN_LENGTH - 2, flight.time,
-           OPERATION_COLUMN_LENGHT - 2, flight.operation == TAKEOFF ? "Decolagem" : "Pouso",
-           EMERGENCY_COLUMN_LENGTH - 2, flight.emergency ? "Sim" : "Nao",
-           PRIORITY_COLUMN_LENGTH - 2, flight.priority);
+    // Início do conteúdo de cada coluna (após "| ")
+    enum
+    {
+        ID_CELL = 2,
+        FUEL_CELL = ID_CELL + ID_COLUMN_LENGTH + 1,
+        TIME_CELL = FUEL_CELL + FUEL_COLUMN_LENGTH + 1,
+        OPERATION_CELL = TIME_CELL + TIME_COLUMN_LENGTH + 1,
+        EMERGENCY_CELL = OPERATION_CELL + OPERATION_COLUMN_LENGHT + 1,
+        PRIORITY_CELL = EMERGENCY_CELL + EMERGENCY_COLUMN_LENGTH + 1,
+        ROW_LENGTH = HORIZONTAL_LINE_LENGTH + 1
+    };
+    static const size_t cells[] = {ID_CELL, FUEL_CELL, TIME_CELL, OPERATION_CELL, EMERGENCY_CELL,
+                                   PRIORITY_CELL};
+    static char model[2 * ROW_LENGTH];
 
-    draw_horizontal_line();
+    // Monta o modelo na primeira chamada, com as mesmas células de append_cell
+    if (model[0] == '\0')
+    {
+        memset(model, ' ', ROW_LENGTH);
+        model[0] = '|';
+
+        for (size_t i = 1; i < sizeof(cells) / sizeof(cells[0]); i++)
+            model[cells[i] - 2] = '|';
+
+        model[ROW_LENGTH - 2] = '|';
+
+        model[ROW_LENGTH - 1] = '\n';
+        memset(model + ROW_LENGTH, '-', HORIZONTAL_LINE_LENGTH);
+        model[2 * ROW_LENGTH - 1] = '\n';
+    }
+
+    if (table.length + sizeof(model) > TABLE_BUFFER_SIZE)
+        flush_table();
+
+    char *row = table.data + table.length;
+    const char *operation = flight->operation == TAKEOFF ? "Decolagem" : "Pouso";
+    char id[MAX_LEN];
+
+    unpack_id(flight->id, id);
+
+    memcpy(row, model, sizeof(model));
+    memcpy(row + ID_CELL, id, strlen(id));
+    write_number(row + FUEL_CELL, flight->fuel);
+    write_number(row + TIME_CELL, flight->time);
+    memcpy(row + OPERATION_CELL, operation, strlen(operation));
+    memcpy(row + EMERGENCY_CELL, flight->emergency ? "Sim" : "Nao", 3);
+    write_number(row + PRIORITY_CELL, flight->priority);
+
+    table.length += sizeof(model);
+}
+
+/**
+ * @brief Lê uma linha inteira da entrada padrão.
+ *
+ * O '\n' é consumido e não é guardado. Os caracteres que não cabem no
+ * buffer são descartados, de modo que a próxima leitura começa na linha
+ * seguinte.
+ *
+ * @param buffer Recebe a linha, terminada em '\0'.
+ * @param size Tamanho do buffer.
+ * @return true se a linha coube no buffer, false se foi truncada.
+ */
+static bool read_line(char *buffer, size_t size)
+{
+    size_t length = 0;
+    bool fits = true;
+    int c;
+
+    while ((c = getchar()) != EOF && c != '\n')
+    {
+        if (length + 1 < size)
+            buffer[length++] = (char)c;
+        else
+            fits = false;
+    }
+
+    buffer[length] = '\0';
+
+    return fits;
 }
 
 /**
@@ -80,14 +238,17 @@ static void draw_row(Flight flight)
  *
  * Esta função solicita ao usuário as informações do voo (ID, combustível, tempo,
  * operação e emergência) e cria um novo objeto de voo. O voo é inserido na estrutura
- * de dados `heap` após calcular sua prioridade.
+ * de dados `heap` após calcular sua prioridade. O ID é lido como uma linha
+ * inteira e pedido de novo se estiver vazio ou tiver mais de MAX_LEN - 1
+ * caracteres.
  *
  * @param heap A estrutura de dados heap onde o voo será inserido.
  */
 void handle_flight_insert(Heap *heap)
 {
     Flight new_flight;
-    char aux_string[MAX_LEN];
+    char id[MAX_LEN];
+    char aux_string[64];
 
     char keys[5][64] = {
         {"ID"},
@@ -97,8 +258,21 @@ void handle_flight_insert(Heap *heap)
         {"Emergencia? S/N"},
     };
 
+    // Descarta o '\n' deixado pela leitura da opção do menu
+    getchar();
+
+ATTR0:
+
     printf("%s: ", keys[0]);
-    scanf("%63s", (char *)new_flight.id);
+
+    if (!read_line(id, sizeof(id)) || (new_flight.id = pack_id(id)) == 0)
+    {
+        if (feof(stdin))
+            return;
+
+        printf("O ID deve ter de 1 a %d caracteres.\n", MAX_LEN - 1);
+        goto ATTR0;
+    }
 
     printf("%s: ", keys[1]);
     scanf("%hu", (ushort *)&new_flight.fuel);
@@ -168,22 +342,32 @@ void handle_flights_import(Heap *heap)
 }
 
 /**
- * @brief Exibe o próximo voo na fila de prioridade.
+ * @brief Exibe os próximos voos na fila de prioridade.
  *
- * Esta função exibe o próximo voo que será processado, ou seja, o voo com a maior
- * prioridade na estrutura de dados heap. A função também exibe o cabeçalho da tabela
- * antes de exibir os dados do voo.
+ * Esta função exibe os NEXT_FLIGHTS voos que serão processados primeiro, na
+ * ordem de despacho, sem alterar a heap (ver top_k). A função também exibe o
+ * cabeçalho da tabela antes de exibir os dados dos voos.
  *
- * @param heap A estrutura de dados heap da qual o voo será mostrado.
+ * @param heap A estrutura de dados heap da qual os voos serão mostrados.
  */
 void handle_next_flight(Heap *heap)
 {
-    Flight *next = top(heap);
+    Flight next[NEXT_FLIGHTS];
+
+    if (heap == NULL || heap->size == 0)
+    {
+        printf("\nNao ha voos na fila.\n");
+        return;
+    }
+
+    size_t count = top_k(heap, NEXT_FLIGHTS, next);
 
     draw_table_header();
 
-    if (heap != NULL)
-        draw_row(*next);
+    for (size_t i = 0; i < count; i++)
+        draw_row(&next[i]);
+
+    flush_table();
 }
 
 /**
@@ -191,26 +375,27 @@ void handle_next_flight(Heap *heap)
  *
  * Esta função solicita ao usuário o ID do voo a ser editado e, se o voo existir,
  * permite que o usuário altere seus atributos (combustível, tempo, operação, emergência).
- * Após as alterações, o voo é reinserido na estrutura de dados heap.
+ * Após as alterações, o voo é reposicionado na própria heap por update_flight.
  *
  * @param heap A estrutura de dados heap onde o voo será editado.
  */
 void handle_flight_edit(Heap *heap)
 {
-    char aux_string[MAX_LEN];
+    char id[64];
+    char aux_string[64];
+    Flight fields;
+
     printf("ID do Voo para editar: ");
-    scanf("%63s", aux_string);
+    scanf("%63s", id);
 
-    Flight *flight = excluir(heap, aux_string);
+    FlightKey key = pack_id(id);
 
-    if (flight == NULL)
+    if (find_flight(heap, key) == NULL)
     {
         printf("\nEdit invalida!\n");
         return;
     }
 
-    strcpy((*flight).id, aux_string);
-
     char keys[5][64] = {
         {"Combustivel"},
         {"Tempo"},
@@ -219,11 +404,11 @@ void handle_flight_edit(Heap *heap)
     };
 
     printf("%s: ", keys[0]);
-    scanf("%hu", (ushort *)&(*flight).fuel);
+    scanf("%hu", (ushort *)&fields.fuel);
     getchar();
 
     printf("%s: ", keys[1]);
-    scanf("%hu", (ushort *)&(*flight).time);
+    scanf("%hu", (ushort *)&fields.time);
     getchar();
 
 ATTR3:
@@ -232,9 +417,9 @@ ATTR3:
     scanf("%63s", aux_string);
 
     if (strcmp(aux_string, "D") == 0)
-        (*flight).operation = TAKEOFF;
+        fields.operation = TAKEOFF;
     else if (strcmp(aux_string, "P") == 0)
-        (*flight).operation = LANDING;
+        fields.operation = LANDING;
     else
         goto ATTR3;
 
@@ -244,32 +429,134 @@ ATTR4:
     scanf("%63s", aux_string);
 
     if (strcmp(aux_string, "S") == 0)
-        (*flight).emergency = 1;
+        fields.emergency = 1;
     else if (strcmp(aux_string, "N") == 0)
-        (*flight).emergency = 0;
+        fields.emergency = 0;
     else
         goto ATTR4;
 
-    (*flight).priority = calculate_priority(*flight);
-
-    insert(heap, *flight);
+    update_flight(heap, key, fields);
 }
 
 /**
- * @brief Exibe todos os voos na fila de prioridade.
+ * @brief Exibe os voos na fila de prioridade.
  *
- * Esta função exibe todos os voos na estrutura de dados heap. Para cada voo,
- * é exibida uma linha da tabela com os dados do voo. O cabeçalho da tabela também
- * é exibido antes dos dados dos voos.
+ * Esta função pergunta se os voos devem ser exibidos na ordem de despacho,
+ * quantos voos pular e quantos exibir (0 exibe todos). Na ordem de
+ * despacho, os voos da página são obtidos por top_k, uma ordenação parcial
+ * que não altera a heap; caso contrário, seguem a ordem da estrutura (ver
+ * next_flight). A tabela é montada em um buffer grande e escrita em poucas
+ * chamadas a fwrite.
  *
  * @param heap A estrutura de dados heap onde os voos são armazenados.
  */
 void handle_flights_show(Heap *heap)
 {
+    char answer[64];
+    size_t offset = 0;
+    size_t limit = 0;
+
+    if (heap == NULL)
+        return;
+
+    printf("Exibir na ordem de despacho? S/N: ");
+    scanf("%63s", answer);
+    bool sorted = answer[0] == 'S' || answer[0] == 's';
+
+    printf("Pular quantos voos? ");
+    scanf("%zu", &offset);
+
+    printf("Exibir quantos voos (0 = todos)? ");
+    scanf("%zu", &limit);
+
+    if (offset > heap->size)
+        offset = heap->size;
+
+    if (limit == 0 || limit > heap->size - offset)
+        limit = heap->size - offset;
+
     draw_table_header();
-    if (heap != NULL)
+
+    if (sorted)
     {
-        for (int i = 0; i < heap->size; i++)
-            draw_row(heap->data[i]);
+        // A página é o fim dos offset + limit primeiros voos
+        Flight *flights = (Flight *)malloc((offset + limit > 0 ? offset + limit : 1) * sizeof(Flight));
+
+        if (flights == NULL)
+            fprintf(stderr, "Memoria insuficiente para ordenar os voos.\n");
+        else
+        {
+            size_t count = top_k(heap, offset + limit, flights);
+
+            for (size_t i = offset; i < count; i++)
+                draw_row(&flights[i]);
+
+            free(flights);
+        }
     }
+    else
+    {
+        size_t cursor = 0;
+        Flight *flight;
+
+        for (size_t i = 0; i < offset + limit && (flight = next_flight(heap, &cursor)) != NULL; i++)
+            if (i >= offset)
+                draw_row(flight);
+    }
+
+    flush_table();
+}
+
+/**
+ * @brief Grava o estado atual da fila de prioridade em um snapshot.
+ *
+ * Esta função solicita ao usuário o caminho do arquivo e grava nele um
+ * snapshot binário da heap, que pode ser restaurado sem reprocessar CSV.
+ *
+ * @param heap A estrutura de dados heap a ser gravada.
+ */
+void handle_snapshot_save(Heap *heap)
+{
+    char path[256];
+    getchar();
+
+    printf("Caminho do snapshot: ");
+    scanf("%255[^\n]", path);
+
+    if (save_snapshot(heap, path))
+        printf("\nSnapshot salvo com %zu voos!\n", heap->size);
+}
+
+/**
+ * @brief Restaura a fila de prioridade a partir de um snapshot.
+ *
+ * Esta função solicita ao usuário o caminho de um snapshot e substitui o
+ * conteúdo da heap pelo estado gravado nele.
+ *
+ * @param heap A estrutura de dados heap a ser restaurada.
+ */
+void handle_snapshot_load(Heap *heap)
+{
+    char path[256];
+    getchar();
+
+    printf("Caminho do snapshot: ");
+    scanf("%255[^\n]", path);
+
+    if (load_snapshot(heap, path, NULL))
+        printf("\nSnapshot restaurado com %zu voos!\n", heap->size);
+}
+
+/**
+ * @brief Exibe as estatísticas de instrumentação da heap.
+ *
+ * Mostra, por operação, as chamadas, comparações, movimentos, profundidade
+ * dos ajustes, sondagens no índice e latência (se compilado com HEAP_STATS).
+ *
+ * @param heap A estrutura de dados heap.
+ */
+void handle_stats(Heap *heap)
+{
+    printf("\n");
+    print_stats(stdout, heap);
 }
@@ -0,0 +1,471 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define fsync _commit
+#define ftruncate _chsize
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+#include "journal.h"
+
+// Diário de operações com gravação agrupada (group commit).
+struct Journal
+{
+    FILE *file;                 //! Arquivo do diário, aberto para acréscimo.
+    pthread_t flusher;          //! Thread que grava os registros pendentes.
+    pthread_mutex_t lock;       //! Protege todos os campos abaixo.
+    pthread_cond_t wake;        //! Sinaliza registros pendentes para a thread.
+    pthread_cond_t flushed;     //! Sinaliza o fim de uma gravação.
+    JournalRecord *pending;     //! Registros ainda não gravados.
+    size_t pending_count;       //! Quantidade de registros pendentes.
+    size_t pending_capacity;    //! Capacidade do vetor de pendentes.
+    uint64_t sequence;          //! Sequência da última operação registrada.
+    uint64_t durable;           //! Sequência da última operação em disco.
+    unsigned window_ms;         //! Janela de agrupamento (em milissegundos).
+    bool urgent;                //! Indica que a gravação não deve esperar a janela.
+    bool closing;               //! Indica que o diário está sendo fechado.
+};
+
+/**
+ * @brief Calcula o hash FNV-1a (32 bits) de um registro.
+ *
+ * O campo `checksum` é considerado zerado no cálculo.
+ *
+ * @param record Registro a ser verificado.
+ * @return uint32_t Valor do hash.
+ */
+static uint32_t record_checksum(const JournalRecord *record)
+{
+    JournalRecord copy = *record;
+    const unsigned char *bytes = (const unsigned char *)&copy;
+    uint32_t hash = 2166136261u;
+
+    copy.checksum = 0;
+
+    for (size_t i = 0; i < sizeof(copy); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Reaplica na heap um registro do diário.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param record Registro a ser aplicado.
+ */
+static void apply_record(Heap *heap, const JournalRecord *record)
+{
+    switch (record->op)
+    {
+    case JOURNAL_INSERT:
+        insert(heap, record->flight);
+        break;
+    case JOURNAL_POP:
+        pop(heap);
+        break;
+    case JOURNAL_DELETE:
+        excluir(heap, record->flight.id, NULL);
+        break;
+    case JOURNAL_UPDATE:
+        update_flight(heap, record->flight.id, record->flight);
+        break;
+    case JOURNAL_CLEAR:
+        clear_flights(heap);
+        break;
+    }
+}
+
+/**
+ * @brief Reaplica na heap as operações registradas em um diário.
+ *
+ * Lê os registros em ordem e aplica apenas os de sequência maior que
+ * `*sequence` (isto é, posteriores ao snapshot de onde a heap foi carregada,
+ * ou todos, se `*sequence` for zero). A leitura para no primeiro registro
+ * incompleto ou corrompido, resultado de uma queda durante a gravação, e o
+ * arquivo é truncado nesse ponto para que novos registros não fiquem atrás
+ * de lixo. Um diário inexistente ou vazio equivale a um diário sem
+ * registros. Um diário sem cabeçalho ou gravado em outro formato (outra
+ * versão ou outro tamanho de registro ou de voo) é recusado, já que seus
+ * registros seriam lidos com campos trocados.
+ *
+ * @param heap Ponteiro para a heap (sem diário associado).
+ * @param file_path Caminho do diário.
+ * @param sequence Entrada: última sequência já contida na heap. Saída:
+ *                 última sequência válida do diário.
+ * @return true se o diário foi lido, false em caso de erro de E/S ou formato incompatível.
+ */
+bool journal_replay(Heap *heap, const char *file_path, uint64_t *sequence)
+{
+    FILE *input_file = fopen(file_path, "rb+");
+
+    if (!input_file)
+        return errno == ENOENT;
+
+    JournalHeader header;
+    JournalRecord record;
+    uint64_t last = 0;
+    long valid_length = (long)sizeof(header);
+    size_t applied = 0;
+
+    memset(&header, 0, sizeof(header));
+
+    // Um arquivo vazio ainda não recebeu o cabeçalho (ver journal_open)
+    if (fread(&header, sizeof(header), 1, input_file) != 1 && ftell(input_file) == 0)
+    {
+        fclose(input_file);
+        return true;
+    }
+
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0 || header.version != JOURNAL_VERSION ||
+        header.record_size != sizeof(JournalRecord) || header.flight_size != sizeof(Flight))
+    {
+        fprintf(stderr, "Diario \"%s\" gravado em um formato incompativel.\n", file_path);
+        fclose(input_file);
+        return false;
+    }
+
+    while (fread(&record, sizeof(record), 1, input_file) == 1 &&
+           record.checksum == record_checksum(&record) &&
+           record.op >= JOURNAL_INSERT && record.op <= JOURNAL_CLEAR &&
+           record.sequence > last)
+    {
+        last = record.sequence;
+        valid_length += (long)sizeof(record);
+
+        if (record.sequence > *sequence)
+        {
+            apply_record(heap, &record);
+            applied++;
+        }
+    }
+
+    // Descarta um final incompleto ou corrompido
+    if (!feof(input_file) || ftell(input_file) != valid_length)
+    {
+        fprintf(stderr, "Diario \"%s\" truncado apos o registro %llu.\n", file_path, (unsigned long long)last);
+        fflush(input_file);
+
+        if (ftruncate(fileno(input_file), valid_length) != 0)
+        {
+            fprintf(stderr, "Unable to write file \"%s\": %s.\n", file_path, strerror(errno));
+            fclose(input_file);
+            return false;
+        }
+    }
+
+    fclose(input_file);
+
+    if (last > *sequence)
+        *sequence = last;
+
+    if (applied > 0)
+        printf("%zu operacoes reaplicadas a partir de \"%s\".\n", applied, file_path);
+
+    return true;
+}
+
+/**
+ * @brief Calcula o instante em que a janela de agrupamento termina.
+ *
+ * @param window_ms Duração da janela (em milissegundos).
+ * @return struct timespec Instante absoluto (relógio de tempo real).
+ */
+static struct timespec window_deadline(unsigned window_ms)
+{
+    struct timespec deadline;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+
+    deadline.tv_sec += window_ms / 1000;
+    deadline.tv_nsec += (long)(window_ms % 1000) * 1000000L;
+
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    return deadline;
+}
+
+/**
+ * @brief Laço da thread que grava os registros pendentes.
+ *
+ * Ao receber o primeiro registro de um lote, espera até o fim da janela de
+ * agrupamento (ou até o lote atingir JOURNAL_BATCH registros, ou até uma
+ * sincronização explícita) e grava todo o lote com um único fwrite seguido
+ * de um único fsync. As operações nunca esperam pelo disco: apenas copiam o
+ * registro para a memória.
+ *
+ * @param arg Ponteiro para o Journal.
+ * @return void* Sempre NULL.
+ */
+static void *flush_loop(void *arg)
+{
+    Journal *journal = (Journal *)arg;
+    JournalRecord *batch = NULL;
+    size_t batch_capacity = 0;
+
+    pthread_mutex_lock(&journal->lock);
+
+    while (true)
+    {
+        while (journal->pending_count == 0 && !journal->closing)
+            pthread_cond_wait(&journal->wake, &journal->lock);
+
+        if (journal->pending_count == 0)
+            break;
+
+        // Aguarda a janela para agrupar mais registros
+        struct timespec deadline = window_deadline(journal->window_ms);
+
+        while (!journal->urgent && !journal->closing && journal->pending_count < JOURNAL_BATCH)
+            if (pthread_cond_timedwait(&journal->wake, &journal->lock, &deadline) != 0)
+                break;
+
+        // Troca os vetores para gravar sem segurar o lock
+        JournalRecord *records = journal->pending;
+        size_t records_capacity = journal->pending_capacity;
+        size_t count = journal->pending_count;
+        uint64_t sequence = journal->sequence;
+
+        journal->pending = batch;
+        journal->pending_capacity = batch_capacity;
+        journal->pending_count = 0;
+        journal->urgent = false;
+
+        batch = records;
+        batch_capacity = records_capacity;
+
+        pthread_mutex_unlock(&journal->lock);
+
+        if (fwrite(records, sizeof(JournalRecord), count, journal->file) != count ||
+            fflush(journal->file) != 0 || fsync(fileno(journal->file)) != 0)
+            fprintf(stderr, "Falha ao gravar o diario: %s.\n", strerror(errno));
+
+        pthread_mutex_lock(&journal->lock);
+
+        journal->durable = sequence;
+        pthread_cond_broadcast(&journal->flushed);
+    }
+
+    pthread_mutex_unlock(&journal->lock);
+
+    free(batch);
+
+    return NULL;
+}
+
+/**
+ * @brief Abre um diário para registrar novas operações.
+ *
+ * Os novos registros são acrescentados ao final do arquivo (criado se não
+ * existir), continuando a numeração a partir de `sequence`. Um arquivo
+ * vazio recebe antes o cabeçalho (ver JournalHeader), gravado em disco
+ * imediatamente. A gravação dos registros é feita por uma thread própria,
+ * em lotes (ver flush_loop).
+ *
+ * @param file_path Caminho do diário.
+ * @param sequence Sequência da última operação já registrada.
+ * @param window_ms Janela de agrupamento (em milissegundos).
+ * @return Journal* Diário aberto ou NULL em caso de erro.
+ */
+Journal *journal_open(const char *file_path, uint64_t sequence, unsigned window_ms)
+{
+    Journal *journal = (Journal *)calloc(1, sizeof(Journal));
+
+    if (journal == NULL)
+        return NULL;
+
+    journal->file = fopen(file_path, "ab");
+
+    if (!journal->file)
+    {
+        fprintf(stderr, "Unable to write file \"%s\": %s.\n", file_path, strerror(errno));
+        free(journal);
+        return NULL;
+    }
+
+    // Um diário novo começa pelo cabeçalho
+    if (fseek(journal->file, 0, SEEK_END) == 0 && ftell(journal->file) == 0)
+    {
+        JournalHeader header;
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        header.version = JOURNAL_VERSION;
+        header.record_size = sizeof(JournalRecord);
+        header.flight_size = sizeof(Flight);
+
+        if (fwrite(&header, sizeof(header), 1, journal->file) != 1 || fflush(journal->file) != 0 ||
+            fsync(fileno(journal->file)) != 0)
+        {
+            fprintf(stderr, "Unable to write file \"%s\": %s.\n", file_path, strerror(errno));
+            fclose(journal->file);
+            free(journal);
+            return NULL;
+        }
+    }
+
+    journal->sequence = sequence;
+    journal->durable = sequence;
+    journal->window_ms = window_ms;
+
+    pthread_mutex_init(&journal->lock, NULL);
+    pthread_cond_init(&journal->wake, NULL);
+    pthread_cond_init(&journal->flushed, NULL);
+
+    if (pthread_create(&journal->flusher, NULL, flush_loop, journal) != 0)
+    {
+        fprintf(stderr, "Nao foi possivel iniciar a gravacao do diario.\n");
+        pthread_mutex_destroy(&journal->lock);
+        pthread_cond_destroy(&journal->wake);
+        pthread_cond_destroy(&journal->flushed);
+        fclose(journal->file);
+        free(journal);
+        return NULL;
+    }
+
+    return journal;
+}
+
+/**
+ * @brief Registra uma operação no diário.
+ *
+ * O registro é apenas copiado para o lote pendente, em O(1) amortizado; a
+ * gravação em disco acontece depois, na thread do diário.
+ *
+ * @param journal Diário (se NULL, nada é feito).
+ * @param op Tipo de operação.
+ * @param flight Voo da operação (pode ser NULL para JOURNAL_POP e JOURNAL_CLEAR).
+ */
+void journal_record(Journal *journal, JournalOp op, const Flight *flight)
+{
+    if (journal == NULL)
+        return;
+
+    JournalRecord record;
+
+    memset(&record, 0, sizeof(record));
+    record.op = op;
+
+    if (flight != NULL)
+        record.flight = *flight;
+
+    pthread_mutex_lock(&journal->lock);
+
+    if (journal->pending_count == journal->pending_capacity)
+    {
+        size_t capacity = journal->pending_capacity == 0 ? 64 : journal->pending_capacity * 2;
+        JournalRecord *pending = (JournalRecord *)realloc(journal->pending, capacity * sizeof(JournalRecord));
+
+        if (pending == NULL)
+        {
+            pthread_mutex_unlock(&journal->lock);
+            fprintf(stderr, "Memoria insuficiente para registrar a operacao.\n");
+            return;
+        }
+
+        journal->pending = pending;
+        journal->pending_capacity = capacity;
+    }
+
+    record.sequence = ++journal->sequence;
+    record.checksum = record_checksum(&record);
+
+    journal->pending[journal->pending_count++] = record;
+
+    // Acorda a thread no início de um lote ou quando o lote enche
+    if (journal->pending_count == 1 || journal->pending_count == JOURNAL_BATCH)
+        pthread_cond_signal(&journal->wake);
+
+    pthread_mutex_unlock(&journal->lock);
+}
+
+/**
+ * @brief Retorna o número de sequência da última operação registrada.
+ *
+ * @param journal Diário (se NULL, retorna zero).
+ * @return uint64_t Sequência da última operação.
+ */
+uint64_t journal_sequence(Journal *journal)
+{
+    if (journal == NULL)
+        return 0;
+
+    pthread_mutex_lock(&journal->lock);
+    uint64_t sequence = journal->sequence;
+    pthread_mutex_unlock(&journal->lock);
+
+    return sequence;
+}
+
+/**
+ * @brief Aguarda até que todas as operações registradas estejam em disco.
+ *
+ * Antecipa a gravação do lote pendente, sem esperar a janela.
+ *
+ * @param journal Diário (se NULL, nada é feito).
+ */
+void journal_sync(Journal *journal)
+{
+    if (journal == NULL)
+        return;
+
+    pthread_mutex_lock(&journal->lock);
+
+    uint64_t target = journal->sequence;
+
+    if (journal->durable < target)
+    {
+        journal->urgent = true;
+        pthread_cond_signal(&journal->wake);
+    }
+
+    while (journal->durable < target)
+        pthread_cond_wait(&journal->flushed, &journal->lock);
+
+    pthread_mutex_unlock(&journal->lock);
+}
+
+/**
+ * @brief Grava as operações pendentes e fecha o diário.
+ *
+ * @param journal Ponteiro para o diário (definido como NULL ao final).
+ */
+void journal_close(Journal **journal)
+{
+    if (*journal == NULL)
+        return;
+
+    pthread_mutex_lock(&(*journal)->lock);
+    (*journal)->closing = true;
+    pthread_cond_signal(&(*journal)->wake);
+    pthread_mutex_unlock(&(*journal)->lock);
+
+    pthread_join((*journal)->flusher, NULL);
+
+    pthread_mutex_destroy(&(*journal)->lock);
+    pthread_cond_destroy(&(*journal)->wake);
+    pthread_cond_destroy(&(*journal)->flushed);
+
+    fclose((*journal)->file);
+    free((*journal)->pending);
+    free(*journal);
+
+    *journal = NULL;
+}
@@ -1,28 +1,178 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "flight.h"
+#include "csv.h"
 #include "menu.h"
+#include "snapshot.h"
+#include "journal.h"
+#include "trace.h"
+#include "batch.h"
+#include "stream.h"
+#include "network.h"
+#include "simulation.h"
 
 int main(int argc, char *argv[])
 {
-    if (argc == 1)
+    char *file_path = NULL;
+    char *snapshot_path = NULL;
+    char *journal_path = NULL;
+    char *batch_path = NULL;
+    char *trace_path = NULL;
+    bool stream = false;
+    bool airports = false;
+    bool simulate = false;
+    bool stats = false;
+    uint64_t stats_every = 0;
+    size_t rate = 1;
+    size_t tick = 1;
+    unsigned commit_window = JOURNAL_DEFAULT_WINDOW;
+    uint64_t sequence = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+            set_import_threads((size_t)strtoul(argv[++i], NULL, 10));
+        else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc)
+            snapshot_path = argv[++i];
+        else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc)
+            journal_path = argv[++i];
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+        else if (strcmp(argv[i], "--commit-window") == 0 && i + 1 < argc)
+            commit_window = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc)
+            batch_path = argv[++i];
+        else if (strcmp(argv[i], "--stream") == 0)
+            stream = true;
+        else if (strcmp(argv[i], "--airports") == 0)
+            airports = true;
+        else if (strcmp(argv[i], "--simulate") == 0)
+            simulate = true;
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats = true;
+        else if (strcmp(argv[i], "--stats-every") == 0 && i + 1 < argc)
+        {
+            stats_every = (uint64_t)strtoull(argv[++i], NULL, 10);
+            stats = true;
+        }
+        else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc)
+            rate = (size_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--tick") == 0 && i + 1 < argc)
+            tick = (size_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc)
+        {
+            const char *engine = argv[++i];
+
+            if (strcmp(engine, "binary") == 0)
+                set_heap_engine(ENGINE_BINARY);
+            else if (strcmp(engine, "bucket") == 0)
+                set_heap_engine(ENGINE_BUCKET);
+            else if (strcmp(engine, "pairing") == 0)
+                set_heap_engine(ENGINE_PAIRING);
+            else
+            {
+                fprintf(stderr, "Estrutura desconhecida: %s.\n", engine);
+                return EXIT_FAILURE;
+            }
+        }
+        else
+            file_path = argv[i];
+    }
+
+    if (file_path == NULL && snapshot_path == NULL && batch_path == NULL && !stream)
+    {
+        printf("Usage: fly [-j threads] [--engine binary|bucket|pairing] [--restore snapshot] [--journal file [--commit-window ms]] [--trace file]\n"
+               "           [--batch script|- | --stream [--rate flights] [--tick rows]] [--stats | --stats-every ops] <file.csv>\n"
+               "       fly --airports [--engine binary|bucket|pairing] --batch script|- [file.csv]\n"
+               "       fly --simulate [--rate flights] [--engine binary|bucket|pairing] [--restore snapshot] [--stats] <file.csv>\n");
+        return EXIT_FAILURE;
+    }
+
+    // Rede de aeroportos: um CSV com a coluna de aeroporto e um roteiro
+    if (airports)
+    {
+        if (batch_path == NULL || snapshot_path != NULL || journal_path != NULL || trace_path != NULL || stream ||
+            stats)
+        {
+            fprintf(stderr, "--airports exige --batch e nao aceita --restore, --journal, --trace, --stats nem --stream.\n");
+            return EXIT_FAILURE;
+        }
+
+        setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
+        Network *network = network_create();
+
+        if (network == NULL)
+            return EXIT_FAILURE;
+
+        bool success = (file_path == NULL || network_load(network, file_path)) &&
+                       run_network_batch(network, batch_path);
+
+        network_destroy(&network);
+
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (simulate && (batch_path != NULL || journal_path != NULL || stream))
+    {
+        fprintf(stderr, "--simulate nao aceita --batch, --journal nem --stream.\n");
+        return EXIT_FAILURE;
+    }
+
+    // No menu, as estatísticas são exibidas pela própria opção do menu
+    if (stats && batch_path == NULL && !stream && !simulate)
     {
-        printf("Usage: fly <file.csv>\n");
+        fprintf(stderr, "--stats e --stats-every exigem --batch, --stream ou --simulate.\n");
         return EXIT_FAILURE;
     }
 
+    // Sem interação, a saída só precisa ser descarregada ao final
+    if (batch_path != NULL || stream || simulate)
+        setvbuf(stdout, NULL, _IOFBF, OUTPUT_BUFFER_SIZE);
+
     Heap *heap = initialize();
 
     if (heap == NULL)
         return EXIT_FAILURE;
 
-    bool success = load_flights(argv[1], heap);
+    // O snapshot é restaurado primeiro e o CSV, se houver, é importado por cima
+    bool success = (snapshot_path == NULL || load_snapshot(heap, snapshot_path, &sequence)) &&
+                   (file_path == NULL || load_flights(file_path, heap));
+
+    // Reaplica o diário sobre o estado carregado e passa a registrar as novas operações
+    if (success && journal_path != NULL)
+        success = journal_replay(heap, journal_path, &sequence) &&
+                  (heap->journal = journal_open(journal_path, sequence, commit_window)) != NULL;
 
-    if (success)
-        main_loop(heap);
-    else
+    // O rastro começa pelo estado carregado e registra todas as operações seguintes
+    if (success && trace_path != NULL)
+        success = (heap->trace = trace_open(trace_path, heap)) != NULL;
+
+    if (!success)
         return EXIT_FAILURE;
 
+    if (batch_path != NULL || simulate || stream)
+    {
+        // Sem menu, as estatísticas vão para a saída de erros (periodicamente, se pedido, e ao final)
+        set_stats_period(heap, stats_every);
+
+        if (batch_path != NULL)
+            success = run_batch(heap, batch_path);
+        else if (simulate)
+            success = run_simulation(heap, rate);
+        else
+            success = run_stream(heap, stdin, rate, tick);
+
+        if (stats)
+            print_stats(stderr, heap);
+
+        deallocate(&heap);
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    main_loop(heap);
+
     return EXIT_SUCCESS;
 }
@@ -19,7 +19,7 @@ void main_loop(Heap *heap)
         // Pega a opção do usuário.
         option = render_first_menu();
 
-        if (option < 1 || option > 7)
+        if (option < 1 || option > 10)
         {
             printf("\nOpcao invalida!\n");
             continue;
@@ -47,6 +47,15 @@ void main_loop(Heap *heap)
             handle_flights_import(heap);
             break;
         case 7:
+            handle_snapshot_save(heap);
+            break;
+        case 8:
+            handle_snapshot_load(heap);
+            break;
+        case 9:
+            handle_stats(heap);
+            break;
+        case 10:
             deallocate(&heap);
             return;
         }
@@ -62,7 +71,7 @@ int render_first_menu()
 {
     int option;
 
-    printf("\n1 - Inserir um novo voo\n2 - Remover voo de maior prioridade\n3 - Alterar informacoes de um voo\n4 - Exibir todos os voos\n5 - Consultar proximo voo\n6 - Importar voos por arquivo CSV\n7 - Fechar controle de trafego aereo\n\nOpcao: ");
+    printf("\n1 - Inserir um novo voo\n2 - Remover voo de maior prioridade\n3 - Alterar informacoes de um voo\n4 - Exibir todos os voos\n5 - Consultar proximos voos\n6 - Importar voos por arquivo CSV\n7 - Salvar snapshot\n8 - Restaurar snapshot\n9 - Exibir estatisticas\n10 - Fechar controle de trafego aereo\n\nOpcao: ");
 
     scanf("%d", &option);
 
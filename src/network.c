@@ -0,0 +1,693 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "network.h"
+#include "csv.h"
+
+// Tipo de operação enviada à thread de um aeroporto.
+typedef enum
+{
+    NETWORK_INSERT, //! Insere um voo.
+    NETWORK_LOAD,   //! Une um lote de voos à heap.
+    NETWORK_POP     //! Retira o voo de maior prioridade.
+} NetworkOpType;
+
+// Operação pendente de um aeroporto.
+typedef struct
+{
+    NetworkOpType type; //! Tipo de operação.
+    Flight flight;      //! Voo inserido (NETWORK_INSERT).
+    Flight *batch;      //! Lote de voos, liberado pela thread (NETWORK_LOAD).
+    size_t count;       //! Quantidade de voos do lote (NETWORK_LOAD).
+    Flight *out;        //! Recebe o voo retirado (NETWORK_POP).
+    bool *result;       //! Indica se o lote foi carregado (NETWORK_LOAD) ou se havia voo a retirar (NETWORK_POP).
+} NetworkOp;
+
+// Aeroporto da rede: uma heap comum, acessada apenas pela sua thread.
+typedef struct
+{
+    char code[AIRPORT_LEN];     //! Código do aeroporto.
+    Heap *heap;                 //! Voos do aeroporto (só a thread acessa).
+    pthread_t worker;           //! Thread que executa as operações.
+    pthread_mutex_t lock;       //! Protege a fila de operações e os contadores.
+    pthread_cond_t wake;        //! Sinaliza operações pendentes para a thread.
+    pthread_cond_t done;        //! Sinaliza operações concluídas.
+    NetworkOp *pending;         //! Operações ainda não executadas.
+    size_t pending_count;       //! Quantidade de operações pendentes.
+    size_t pending_capacity;    //! Capacidade do vetor de pendentes.
+    NetworkOp *running;         //! Operações em execução (trocado com `pending`).
+    size_t running_capacity;    //! Capacidade do vetor em execução.
+    uint64_t submitted;         //! Operações enviadas.
+    uint64_t completed;         //! Operações concluídas.
+    uint64_t rejected;          //! Inserções rejeitadas desde a última sincronização (ver network_sync).
+    bool closing;               //! Indica que a thread deve terminar.
+    pthread_mutex_t view_lock;  //! Protege apenas a visão publicada.
+    Flight view[NETWORK_VIEW];  //! Voos de maior prioridade, na ordem de despacho.
+    size_t view_count;          //! Quantidade de voos da visão.
+} Airport;
+
+// Voos de um aeroporto lidos de um arquivo, ainda não enviados à sua thread.
+typedef struct
+{
+    Airport *airport;   //! Aeroporto de destino.
+    Flight *flights;    //! Voos, na ordem do arquivo.
+    size_t count;       //! Quantidade de voos.
+    size_t capacity;    //! Capacidade do vetor de voos.
+    uint64_t ticket;    //! Número da operação de carga (ver submit).
+    bool loaded;        //! Indica se a thread carregou o lote.
+} LoadBatch;
+
+// Rede de aeroportos.
+struct Network
+{
+    Airport **airports; //! Aeroportos, na ordem em que apareceram.
+    size_t count;       //! Quantidade de aeroportos.
+    size_t capacity;    //! Capacidade do vetor de aeroportos.
+};
+
+/**
+ * @brief Publica os voos de maior prioridade de um aeroporto.
+ *
+ * Chamada pela thread do aeroporto depois de cada grupo de operações. Só a
+ * cópia para a visão é feita com a trava da visão.
+ *
+ * @param airport Ponteiro para o aeroporto.
+ */
+static void publish_view(Airport *airport)
+{
+    Flight view[NETWORK_VIEW];
+    size_t count = top_k(airport->heap, NETWORK_VIEW, view);
+
+    pthread_mutex_lock(&airport->view_lock);
+    memcpy(airport->view, view, count * sizeof(Flight));
+    airport->view_count = count;
+    pthread_mutex_unlock(&airport->view_lock);
+}
+
+/**
+ * @brief Executa uma operação na heap do aeroporto.
+ *
+ * As cargas e as retiradas informam o resultado por `op->result`; as
+ * inserções, que não são esperadas, pelo valor de retorno.
+ *
+ * @param airport Ponteiro para o aeroporto.
+ * @param op Operação a executar.
+ * @return false se a inserção foi rejeitada, true caso contrário.
+ */
+static bool execute(Airport *airport, NetworkOp *op)
+{
+    Heap *heap = airport->heap;
+
+    switch (op->type)
+    {
+    case NETWORK_INSERT:
+        return insert(heap, op->flight);
+    case NETWORK_LOAD:
+        // O lote é construído de uma só vez e unido à heap do aeroporto
+        *op->result = merge_flights(heap, op->batch, op->count);
+
+        if (!*op->result)
+            fprintf(stderr, "Nao foi possivel carregar o aeroporto %s.\n", airport->code);
+
+        free(op->batch);
+        break;
+    case NETWORK_POP:
+        *op->result = heap->size > 0;
+
+        if (*op->result)
+        {
+            *op->out = *top(heap);
+            pop(heap);
+        }
+        break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Executa as operações de um aeroporto até o fechamento da rede.
+ *
+ * Função da thread do aeroporto. A cada passagem, todas as operações
+ * pendentes são retiradas de uma vez, executadas sem a trava e seguidas de
+ * uma única publicação da visão.
+ *
+ * @param arg Ponteiro para o Airport.
+ * @return void* Sempre NULL.
+ */
+static void *run_airport(void *arg)
+{
+    Airport *airport = (Airport *)arg;
+
+    pthread_mutex_lock(&airport->lock);
+
+    for (;;)
+    {
+        while (airport->pending_count == 0 && !airport->closing)
+            pthread_cond_wait(&airport->wake, &airport->lock);
+
+        if (airport->pending_count == 0)
+            break;
+
+        // Troca os vetores: novas operações podem chegar durante a execução
+        NetworkOp *ops = airport->pending;
+        size_t count = airport->pending_count;
+        size_t capacity = airport->pending_capacity;
+
+        airport->pending = airport->running;
+        airport->pending_capacity = airport->running_capacity;
+        airport->pending_count = 0;
+        airport->running = ops;
+        airport->running_capacity = capacity;
+
+        pthread_mutex_unlock(&airport->lock);
+
+        uint64_t rejected = 0;
+
+        for (size_t i = 0; i < count; i++)
+            if (!execute(airport, &ops[i]))
+                rejected++;
+
+        publish_view(airport);
+
+        pthread_mutex_lock(&airport->lock);
+        airport->completed += count;
+        airport->rejected += rejected;
+        pthread_cond_broadcast(&airport->done);
+    }
+
+    pthread_mutex_unlock(&airport->lock);
+
+    return NULL;
+}
+
+/**
+ * @brief Envia uma operação à thread de um aeroporto.
+ *
+ * @param airport Ponteiro para o aeroporto.
+ * @param op Operação a enviar.
+ * @return uint64_t Número da operação (ver wait_for) ou 0 se faltar memória.
+ */
+static uint64_t submit(Airport *airport, const NetworkOp *op)
+{
+    pthread_mutex_lock(&airport->lock);
+
+    if (airport->pending_count == airport->pending_capacity)
+    {
+        size_t capacity = airport->pending_capacity == 0 ? 64 : airport->pending_capacity * 2;
+        NetworkOp *pending = (NetworkOp *)realloc(airport->pending, capacity * sizeof(NetworkOp));
+
+        if (pending == NULL)
+        {
+            pthread_mutex_unlock(&airport->lock);
+            fprintf(stderr, "Memoria insuficiente para enviar a operacao ao aeroporto %s.\n", airport->code);
+            return 0;
+        }
+
+        airport->pending = pending;
+        airport->pending_capacity = capacity;
+    }
+
+    airport->pending[airport->pending_count++] = *op;
+
+    uint64_t ticket = ++airport->submitted;
+
+    pthread_cond_signal(&airport->wake);
+    pthread_mutex_unlock(&airport->lock);
+
+    return ticket;
+}
+
+/**
+ * @brief Espera a conclusão de uma operação de um aeroporto.
+ *
+ * @param airport Ponteiro para o aeroporto.
+ * @param ticket Número da operação (ver submit).
+ */
+static void wait_for(Airport *airport, uint64_t ticket)
+{
+    pthread_mutex_lock(&airport->lock);
+
+    while (airport->completed < ticket)
+        pthread_cond_wait(&airport->done, &airport->lock);
+
+    pthread_mutex_unlock(&airport->lock);
+}
+
+/**
+ * @brief Libera um aeroporto cuja thread não está em execução.
+ *
+ * @param airport Ponteiro para o aeroporto.
+ */
+static void free_airport(Airport *airport)
+{
+    pthread_mutex_destroy(&airport->lock);
+    pthread_cond_destroy(&airport->wake);
+    pthread_cond_destroy(&airport->done);
+    pthread_mutex_destroy(&airport->view_lock);
+    deallocate(&airport->heap);
+    free(airport->pending);
+    free(airport->running);
+    free(airport);
+}
+
+/**
+ * @brief Localiza um aeroporto da rede, criando-o se necessário.
+ *
+ * Um aeroporto novo recebe uma heap vazia e a sua própria thread.
+ *
+ * @param network Ponteiro para a rede.
+ * @param code Código do aeroporto.
+ * @param create Indica se o aeroporto deve ser criado caso não exista.
+ * @return Airport* Aeroporto ou NULL se não existir (ou se faltar memória).
+ */
+static Airport *find_airport(Network *network, const char *code, bool create)
+{
+    for (size_t i = 0; i < network->count; i++)
+        if (strcmp(network->airports[i]->code, code) == 0)
+            return network->airports[i];
+
+    if (!create)
+        return NULL;
+
+    if (network->count == network->capacity)
+    {
+        size_t capacity = network->capacity == 0 ? 8 : network->capacity * 2;
+        Airport **airports = (Airport **)realloc(network->airports, capacity * sizeof(Airport *));
+
+        if (airports == NULL)
+        {
+            fprintf(stderr, "Memoria insuficiente para criar o aeroporto %s.\n", code);
+            return NULL;
+        }
+
+        network->airports = airports;
+        network->capacity = capacity;
+    }
+
+    Airport *airport = (Airport *)calloc(1, sizeof(Airport));
+
+    if (airport == NULL || (airport->heap = initialize()) == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para criar o aeroporto %s.\n", code);
+        free(airport);
+        return NULL;
+    }
+
+    strcpy(airport->code, code);
+    pthread_mutex_init(&airport->lock, NULL);
+    pthread_cond_init(&airport->wake, NULL);
+    pthread_cond_init(&airport->done, NULL);
+    pthread_mutex_init(&airport->view_lock, NULL);
+
+    if (pthread_create(&airport->worker, NULL, run_airport, airport) != 0)
+    {
+        fprintf(stderr, "Nao foi possivel iniciar a thread do aeroporto %s.\n", code);
+        free_airport(airport);
+        return NULL;
+    }
+
+    network->airports[network->count++] = airport;
+
+    return airport;
+}
+
+/**
+ * @brief Cria uma rede sem aeroportos.
+ *
+ * Os aeroportos são criados à medida que aparecem nos voos. As funções da
+ * rede devem ser chamadas por uma única thread de controle; as operações
+ * de cada aeroporto são executadas pela thread do aeroporto.
+ *
+ * @return Network* Rede criada ou NULL se a alocação falhar.
+ */
+Network *network_create(void)
+{
+    return (Network *)calloc(1, sizeof(Network));
+}
+
+/**
+ * @brief Encerra as threads e libera a rede.
+ *
+ * As operações pendentes são concluídas antes que as threads terminem.
+ *
+ * @param network Ponteiro para o ponteiro da rede (pode apontar para NULL).
+ */
+void network_destroy(Network **network)
+{
+    if (*network == NULL)
+        return;
+
+    for (size_t i = 0; i < (*network)->count; i++)
+    {
+        Airport *airport = (*network)->airports[i];
+
+        pthread_mutex_lock(&airport->lock);
+        airport->closing = true;
+        pthread_cond_signal(&airport->wake);
+        pthread_mutex_unlock(&airport->lock);
+
+        pthread_join(airport->worker, NULL);
+        free_airport(airport);
+    }
+
+    free((*network)->airports);
+    free(*network);
+    *network = NULL;
+}
+
+/**
+ * @brief Interpreta uma linha no formato aeroporto,id,combustivel,tempo,operacao,emergencia.
+ *
+ * O código do aeroporto deve ter de 1 a AIRPORT_LEN - 1 caracteres; os
+ * demais campos seguem as regras de parse_flight.
+ *
+ * @param line Início da linha.
+ * @param end Fim da linha (posição do '\n' ou do fim do buffer).
+ * @param entry Recebe o aeroporto e o voo lidos.
+ * @return const char* NULL em caso de sucesso ou a descrição do erro.
+ */
+const char *parse_network_flight(const char *line, const char *end, NetworkFlight *entry)
+{
+    const char *comma = (const char *)memchr(line, ',', (size_t)(end - line));
+
+    if (comma == NULL)
+        return "quantidade de campos invalida";
+
+    size_t length = (size_t)(comma - line);
+
+    if (length == 0 || length >= AIRPORT_LEN)
+        return "aeroporto deve ter de 1 a 4 caracteres";
+
+    memset(entry->airport, 0, AIRPORT_LEN);
+    memcpy(entry->airport, line, length);
+
+    return parse_flight(comma + 1, end, &entry->flight);
+}
+
+/**
+ * @brief Carrega os voos de um arquivo, com os aeroportos em paralelo.
+ *
+ * Cada linha tem o formato aeroporto,id,combustivel,tempo,operacao,emergencia.
+ * O arquivo é lido de uma só vez e os voos são separados por aeroporto; o
+ * lote de cada aeroporto é então enviado à sua thread, que o constrói de uma
+ * só vez e o une à heap do aeroporto (ver merge_flights), de modo que os
+ * aeroportos são carregados em paralelo. Linhas inválidas são informadas
+ * com seu número e ignoradas. A função espera o fim das cargas enviadas.
+ *
+ * @param network Ponteiro para a rede.
+ * @param file_path Caminho do arquivo.
+ * @return true se o arquivo foi lido e todos os lotes carregados, false caso contrário.
+ */
+bool network_load(Network *network, const char *file_path)
+{
+    size_t length;
+    char *buffer = read_file(file_path, &length);
+
+    if (buffer == NULL)
+        return false;
+
+    // Lotes de cada aeroporto, na ordem em que os aeroportos aparecem
+    LoadBatch *batches = NULL;
+    size_t batch_count = 0;
+    const char *end = buffer + length;
+    size_t line_number = 0;
+    bool success = true;
+
+    for (const char *line = buffer; success && line < end; line++)
+    {
+        const char *eol = (const char *)memchr(line, '\n', (size_t)(end - line));
+        NetworkFlight entry;
+
+        if (eol == NULL)
+            eol = end;
+
+        line_number++;
+
+        const char *stop = eol > line && eol[-1] == '\r' ? eol - 1 : eol;
+        const char *error;
+
+        // Ignora linhas vazias
+        if (stop == line)
+        {
+            line = eol;
+            continue;
+        }
+
+        if ((error = parse_network_flight(line, stop, &entry)) != NULL)
+        {
+            fprintf(stderr, "%s:%zu: %s.\n", file_path, line_number, error);
+            line = eol;
+            continue;
+        }
+
+        Airport *airport = find_airport(network, entry.airport, true);
+        size_t b = 0;
+
+        while (b < batch_count && batches[b].airport != airport)
+            b++;
+
+        if (airport == NULL)
+            success = false;
+        else if (b == batch_count)
+        {
+            LoadBatch *grown = (LoadBatch *)realloc(batches, (batch_count + 1) * sizeof(LoadBatch));
+
+            if (grown == NULL)
+                success = false;
+            else
+            {
+                batches = grown;
+                batches[batch_count].airport = airport;
+                batches[batch_count].flights = NULL;
+                batches[batch_count].count = 0;
+                batches[batch_count].capacity = 0;
+                batch_count++;
+            }
+        }
+
+        if (success && batches[b].count == batches[b].capacity)
+        {
+            size_t capacity = batches[b].capacity == 0 ? 256 : batches[b].capacity * 2;
+            Flight *flights = (Flight *)realloc(batches[b].flights, capacity * sizeof(Flight));
+
+            if (flights == NULL)
+                success = false;
+            else
+            {
+                batches[b].flights = flights;
+                batches[b].capacity = capacity;
+            }
+        }
+
+        if (success)
+            batches[b].flights[batches[b].count++] = entry.flight;
+
+        line = eol;
+    }
+
+    free(buffer);
+
+    if (!success)
+        fprintf(stderr, "Memoria insuficiente para importar \"%s\".\n", file_path);
+
+    // A thread do aeroporto passa a ser dona do lote
+    for (size_t b = 0; b < batch_count; b++)
+    {
+        NetworkOp op;
+
+        memset(&op, 0, sizeof(op));
+        op.type = NETWORK_LOAD;
+        op.batch = batches[b].flights;
+        op.count = batches[b].count;
+        op.result = &batches[b].loaded;
+
+        batches[b].ticket = success ? submit(batches[b].airport, &op) : 0;
+
+        if (batches[b].ticket == 0)
+        {
+            free(batches[b].flights);
+            success = false;
+        }
+    }
+
+    // Os aeroportos carregam em paralelo; só então os resultados são lidos
+    for (size_t b = 0; b < batch_count; b++)
+    {
+        if (batches[b].ticket == 0)
+            continue;
+
+        wait_for(batches[b].airport, batches[b].ticket);
+
+        if (!batches[b].loaded)
+            success = false;
+    }
+
+    free(batches);
+
+    return success;
+}
+
+/**
+ * @brief Insere um voo em um aeroporto, criando-o se necessário.
+ *
+ * A inserção é executada pela thread do aeroporto, sem espera; um código
+ * repetido é informado por ela (ver insert) e contado como rejeitado (ver
+ * network_sync).
+ *
+ * @param network Ponteiro para a rede.
+ * @param airport Código do aeroporto.
+ * @param flight O voo a ser inserido, com prioridade calculada.
+ * @return true se a inserção foi enviada, false caso contrário.
+ */
+bool network_insert(Network *network, const char *airport, Flight flight)
+{
+    Airport *target = find_airport(network, airport, true);
+    NetworkOp op;
+
+    if (target == NULL)
+        return false;
+
+    memset(&op, 0, sizeof(op));
+    op.type = NETWORK_INSERT;
+    op.flight = flight;
+
+    return submit(target, &op) != 0;
+}
+
+/**
+ * @brief Retira o voo de maior prioridade de um aeroporto.
+ *
+ * A retirada é executada pela thread do aeroporto, depois das operações já
+ * enviadas a ele, e a função espera a sua conclusão.
+ *
+ * @param network Ponteiro para a rede.
+ * @param airport Código do aeroporto.
+ * @param flight Recebe o voo retirado.
+ * @return true se um voo foi retirado, false se o aeroporto não existe ou está vazio.
+ */
+bool network_pop(Network *network, const char *airport, Flight *flight)
+{
+    Airport *target = find_airport(network, airport, false);
+    bool found = false;
+    NetworkOp op;
+
+    if (target == NULL)
+        return false;
+
+    memset(&op, 0, sizeof(op));
+    op.type = NETWORK_POP;
+    op.out = flight;
+    op.result = &found;
+
+    uint64_t ticket = submit(target, &op);
+
+    if (ticket == 0)
+        return false;
+
+    wait_for(target, ticket);
+
+    return found;
+}
+
+/**
+ * @brief Espera todos os aeroportos concluírem as operações já enviadas.
+ *
+ * Informa também as inserções rejeitadas desde a sincronização anterior,
+ * que network_insert não espera.
+ *
+ * @param network Ponteiro para a rede.
+ * @return true se nenhuma inserção foi rejeitada, false caso contrário.
+ */
+bool network_sync(Network *network)
+{
+    uint64_t rejected = 0;
+
+    for (size_t i = 0; i < network->count; i++)
+    {
+        Airport *airport = network->airports[i];
+
+        pthread_mutex_lock(&airport->lock);
+        uint64_t ticket = airport->submitted;
+        pthread_mutex_unlock(&airport->lock);
+
+        wait_for(airport, ticket);
+
+        pthread_mutex_lock(&airport->lock);
+        rejected += airport->rejected;
+        airport->rejected = 0;
+        pthread_mutex_unlock(&airport->lock);
+    }
+
+    return rejected == 0;
+}
+
+/**
+ * @brief Copia os k voos de maior prioridade de toda a rede.
+ *
+ * Combina as visões publicadas pelos aeroportos (ver publish_view), uma
+ * trava de visão por vez, sem tocar nas heaps nem esperar as operações em
+ * andamento: o resultado reflete as operações já concluídas por cada
+ * aeroporto. Por isso, `k` é limitado a NETWORK_VIEW. Empates de
+ * prioridade entre aeroportos seguem a ordem em que os aeroportos
+ * apareceram.
+ *
+ * @param network Ponteiro para a rede.
+ * @param k Quantidade máxima de voos (no máximo NETWORK_VIEW).
+ * @param out Recebe os voos, na ordem de despacho.
+ * @return size_t Quantidade de voos copiados.
+ */
+size_t network_top_k(Network *network, size_t k, NetworkFlight *out)
+{
+    size_t count = network->count;
+    Flight *views = (Flight *)malloc((count > 0 ? count : 1) * NETWORK_VIEW * sizeof(Flight));
+    size_t *sizes = (size_t *)malloc((count > 0 ? count : 1) * sizeof(size_t));
+    size_t *next = (size_t *)calloc(count > 0 ? count : 1, sizeof(size_t));
+    size_t copied = 0;
+
+    if (views == NULL || sizes == NULL || next == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para consultar a rede.\n");
+        k = 0;
+    }
+
+    if (k > NETWORK_VIEW)
+        k = NETWORK_VIEW;
+
+    // Copia cada visão, segurando uma única trava por vez
+    for (size_t i = 0; k > 0 && i < count; i++)
+    {
+        Airport *airport = network->airports[i];
+
+        pthread_mutex_lock(&airport->view_lock);
+        sizes[i] = airport->view_count;
+        memcpy(&views[i * NETWORK_VIEW], airport->view, airport->view_count * sizeof(Flight));
+        pthread_mutex_unlock(&airport->view_lock);
+    }
+
+    // Intercala as visões, que já estão em ordem de despacho
+    for (; copied < k; copied++)
+    {
+        size_t best = count;
+
+        for (size_t i = 0; i < count; i++)
+            if (next[i] < sizes[i] &&
+                (best == count || views[i * NETWORK_VIEW + next[i]].priority >
+                                      views[best * NETWORK_VIEW + next[best]].priority))
+                best = i;
+
+        if (best == count)
+            break;
+
+        strcpy(out[copied].airport, network->airports[best]->code);
+        out[copied].flight = views[best * NETWORK_VIEW + next[best]++];
+    }
+
+    free(views);
+    free(sizes);
+    free(next);
+
+    return copied;
+}
@@ -0,0 +1,359 @@
+#include <stdlib.h>
+
+#include "pairing.h"
+
+// Nó de uma heap de pareamento, indexado pelo slot do voo.
+typedef struct
+{
+    uint32_t priority;  //! Prioridade do voo.
+    uint32_t arrival;   //! Ordem de chegada, que desempata prioridades iguais.
+    uint32_t child;     //! Primeiro filho.
+    uint32_t sibling;   //! Próximo irmão.
+    uint32_t prev;      //! Irmão anterior ou, no primeiro filho, o pai.
+} PairingNode;
+
+// Heap de pareamento.
+struct Pairing
+{
+    PairingNode *nodes; //! Nós, indexados pelo slot do voo.
+    uint32_t root;      //! Slot da raiz (PAIRING_NONE se vazia).
+};
+
+/**
+ * @brief Verifica se um nó deve sair antes de outro.
+ *
+ * Mesma regra da heap binária: maior prioridade e, em caso de empate,
+ * chegada mais antiga (em aritmética modular).
+ *
+ * @param a Primeiro nó.
+ * @param b Segundo nó.
+ * @return true se `a` sai antes de `b`, false caso contrário.
+ */
+static inline bool precedes(const PairingNode *a, const PairingNode *b)
+{
+    if (a->priority != b->priority)
+        return a->priority > b->priority;
+
+    return (uint32_t)(b->arrival - a->arrival - 1) < UINT32_C(0x7FFFFFFF);
+}
+
+/**
+ * @brief Une duas raízes, em O(1).
+ *
+ * A raiz que sai depois vira o primeiro filho da outra.
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param a Slot da primeira raiz (ou PAIRING_NONE).
+ * @param b Slot da segunda raiz (ou PAIRING_NONE).
+ * @return uint32_t Slot da raiz resultante.
+ */
+static uint32_t meld(Pairing *pairing, uint32_t a, uint32_t b)
+{
+    PairingNode *nodes = pairing->nodes;
+
+    if (a == PAIRING_NONE)
+        return b;
+
+    if (b == PAIRING_NONE)
+        return a;
+
+    if (precedes(&nodes[b], &nodes[a]))
+    {
+        uint32_t temp = a;
+        a = b;
+        b = temp;
+    }
+
+    nodes[b].prev = a;
+    nodes[b].sibling = nodes[a].child;
+
+    if (nodes[a].child != PAIRING_NONE)
+        nodes[nodes[a].child].prev = b;
+
+    nodes[a].child = b;
+
+    return a;
+}
+
+/**
+ * @brief Une uma lista de irmãos em uma única árvore.
+ *
+ * Usa o esquema de duas passadas: une os irmãos aos pares da esquerda para
+ * a direita e depois une os pares da direita para a esquerda, o que dá
+ * custo amortizado O(log n) à remoção. Os pares são empilhados pelo próprio
+ * campo `sibling`, sem memória adicional.
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param first Slot do primeiro irmão (ou PAIRING_NONE).
+ * @return uint32_t Slot da raiz resultante.
+ */
+static uint32_t combine(Pairing *pairing, uint32_t first)
+{
+    PairingNode *nodes = pairing->nodes;
+    uint32_t stack = PAIRING_NONE;
+
+    if (first == PAIRING_NONE)
+        return PAIRING_NONE;
+
+    // Primeira passada: une os irmãos aos pares
+    while (first != PAIRING_NONE)
+    {
+        uint32_t a = first;
+        uint32_t b = nodes[a].sibling;
+
+        nodes[a].prev = PAIRING_NONE;
+
+        if (b == PAIRING_NONE)
+        {
+            nodes[a].sibling = stack;
+            stack = a;
+            break;
+        }
+
+        first = nodes[b].sibling;
+        nodes[a].sibling = PAIRING_NONE;
+        nodes[b].sibling = PAIRING_NONE;
+        nodes[b].prev = PAIRING_NONE;
+
+        uint32_t pair = meld(pairing, a, b);
+
+        nodes[pair].sibling = stack;
+        stack = pair;
+    }
+
+    // Segunda passada: une os pares, do último para o primeiro
+    uint32_t root = stack;
+
+    stack = nodes[root].sibling;
+    nodes[root].sibling = PAIRING_NONE;
+
+    while (stack != PAIRING_NONE)
+    {
+        uint32_t next = nodes[stack].sibling;
+
+        nodes[stack].sibling = PAIRING_NONE;
+        root = meld(pairing, root, stack);
+        stack = next;
+    }
+
+    return root;
+}
+
+/**
+ * @brief Cria uma heap de pareamento vazia.
+ *
+ * @param capacity Quantidade de slots.
+ * @return Pairing* Heap criada ou NULL se a alocação falhar.
+ */
+Pairing *pairing_create(size_t capacity)
+{
+    Pairing *pairing = (Pairing *)malloc(sizeof(Pairing));
+
+    if (pairing == NULL)
+        return NULL;
+
+    pairing->nodes = (PairingNode *)malloc(capacity * sizeof(PairingNode));
+    pairing->root = PAIRING_NONE;
+
+    if (pairing->nodes == NULL)
+        pairing_destroy(&pairing);
+
+    return pairing;
+}
+
+/**
+ * @brief Libera a heap de pareamento.
+ *
+ * @param pairing Ponteiro para o ponteiro da heap (pode apontar para NULL).
+ */
+void pairing_destroy(Pairing **pairing)
+{
+    if (*pairing == NULL)
+        return;
+
+    free((*pairing)->nodes);
+    free(*pairing);
+    *pairing = NULL;
+}
+
+/**
+ * @brief Esvazia a heap de pareamento, em O(1).
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ */
+void pairing_clear(Pairing *pairing)
+{
+    pairing->root = PAIRING_NONE;
+}
+
+/**
+ * @brief Insere um slot na heap de pareamento, em O(1).
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param slot Slot do voo.
+ * @param priority Prioridade do voo.
+ * @param arrival Ordem de chegada do voo.
+ */
+void pairing_push(Pairing *pairing, uint32_t slot, unsigned priority, uint32_t arrival)
+{
+    PairingNode *node = &pairing->nodes[slot];
+
+    node->priority = priority;
+    node->arrival = arrival;
+    node->child = PAIRING_NONE;
+    node->sibling = PAIRING_NONE;
+    node->prev = PAIRING_NONE;
+
+    pairing->root = meld(pairing, pairing->root, slot);
+}
+
+/**
+ * @brief Retira um slot da heap de pareamento, em O(log n) amortizado.
+ *
+ * Os filhos do slot são unidos em uma árvore (ver combine), que toma o seu
+ * lugar: na raiz, diretamente; nos demais, o slot é cortado da sua lista de
+ * irmãos e a árvore é unida à raiz.
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param slot Slot do voo (presente na heap).
+ */
+void pairing_remove(Pairing *pairing, uint32_t slot)
+{
+    PairingNode *nodes = pairing->nodes;
+    uint32_t children = combine(pairing, nodes[slot].child);
+
+    if (slot == pairing->root)
+    {
+        pairing->root = children;
+        return;
+    }
+
+    // Corta o slot da lista de irmãos (ou do pai, se for o primeiro filho)
+    uint32_t prev = nodes[slot].prev;
+    uint32_t sibling = nodes[slot].sibling;
+
+    if (nodes[prev].child == slot)
+        nodes[prev].child = sibling;
+    else
+        nodes[prev].sibling = sibling;
+
+    if (sibling != PAIRING_NONE)
+        nodes[sibling].prev = prev;
+
+    pairing->root = meld(pairing, pairing->root, children);
+}
+
+/**
+ * @brief Retorna o slot de maior prioridade, em O(1).
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @return uint32_t Slot da raiz ou PAIRING_NONE se a heap estiver vazia.
+ */
+uint32_t pairing_first(const Pairing *pairing)
+{
+    return pairing->root;
+}
+
+/**
+ * @brief Retorna o slot seguinte no percurso em pré-ordem da heap.
+ *
+ * Desce para o primeiro filho ou, na falta dele, segue para o próximo irmão
+ * do slot ou do ancestral mais próximo que tenha um. O percurso completo
+ * custa O(n).
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param slot Slot atual.
+ * @return uint32_t Slot seguinte ou PAIRING_NONE no fim.
+ */
+uint32_t pairing_next(const Pairing *pairing, uint32_t slot)
+{
+    const PairingNode *nodes = pairing->nodes;
+
+    if (nodes[slot].child != PAIRING_NONE)
+        return nodes[slot].child;
+
+    while (slot != pairing->root)
+    {
+        if (nodes[slot].sibling != PAIRING_NONE)
+            return nodes[slot].sibling;
+
+        // Volta ao primeiro irmão, cujo anterior é o pai
+        while (nodes[nodes[slot].prev].child != slot)
+            slot = nodes[slot].prev;
+
+        slot = nodes[slot].prev;
+    }
+
+    return PAIRING_NONE;
+}
+
+/**
+ * @brief Retorna o primeiro filho de um slot.
+ *
+ * Os filhos de um slot não estão em ordem entre si, mas nenhum sai antes
+ * dele.
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param slot Slot do voo (presente na heap).
+ * @return uint32_t Slot do primeiro filho ou PAIRING_NONE.
+ */
+uint32_t pairing_child(const Pairing *pairing, uint32_t slot)
+{
+    return pairing->nodes[slot].child;
+}
+
+/**
+ * @brief Retorna o próximo irmão de um slot.
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param slot Slot do voo (presente na heap).
+ * @return uint32_t Slot do próximo irmão ou PAIRING_NONE.
+ */
+uint32_t pairing_sibling(const Pairing *pairing, uint32_t slot)
+{
+    return pairing->nodes[slot].sibling;
+}
+
+/**
+ * @brief Retorna a ordem de chegada de um slot.
+ *
+ * @param pairing Ponteiro para a heap de pareamento.
+ * @param slot Slot do voo (presente na heap).
+ * @return uint32_t Ordem de chegada.
+ */
+uint32_t pairing_arrival(const Pairing *pairing, uint32_t slot)
+{
+    return pairing->nodes[slot].arrival;
+}
+
+/**
+ * @brief Incorpora os nós de outra heap de pareamento.
+ *
+ * Copia cada nó de `source` para o slot `slots[s]` desta heap, renumerando
+ * os vínculos e somando `offset` à ordem de chegada, e une a raiz copiada à
+ * raiz desta heap com uma única comparação. `source` não é alterada.
+ *
+ * @param pairing Ponteiro para a heap de pareamento de destino.
+ * @param source Heap de pareamento de origem.
+ * @param slots Slot de destino de cada slot da origem.
+ * @param offset Valor somado à ordem de chegada dos nós copiados.
+ */
+void pairing_absorb(Pairing *pairing, const Pairing *source, const uint32_t *slots, uint32_t offset)
+{
+    if (source->root == PAIRING_NONE)
+        return;
+
+    for (uint32_t slot = source->root; slot != PAIRING_NONE; slot = pairing_next(source, slot))
+    {
+        PairingNode node = source->nodes[slot];
+
+        node.arrival += offset;
+        node.child = node.child == PAIRING_NONE ? PAIRING_NONE : slots[node.child];
+        node.sibling = node.sibling == PAIRING_NONE ? PAIRING_NONE : slots[node.sibling];
+        node.prev = node.prev == PAIRING_NONE ? PAIRING_NONE : slots[node.prev];
+
+        pairing->nodes[slots[slot]] = node;
+    }
+
+    pairing->root = meld(pairing, pairing->root, slots[source->root]);
+}
@@ -0,0 +1,210 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "simulation.h"
+#include "csv.h"
+
+/*
+ * Na simulação, o relógio avança em minutos. A cada minuto, o tempo até o
+ * horário de todo voo diminui em 1 e os voos em pouso, que estão no ar,
+ * queimam 1 unidade de combustível; os dois param em zero. Assim, a
+ * prioridade de um voo cresce 0, 1 ou 2 por minuto (a sua taxa), conforme o
+ * que ainda não se esgotou.
+ *
+ * Voos com a mesma taxa nunca trocam de ordem, então cada taxa tem a sua
+ * heap (classe) e a chave de um voo é fixa enquanto ele estiver nela: a
+ * prioridade que ele teria no minuto SIMULATION_HORIZON se mantivesse a
+ * taxa. Avançar o relógio não toca nas heaps.
+ *
+ * Os campos guardados são os do minuto 0 e os atuais são derivados deles.
+ * Quando o tempo ou o combustível de um voo se esgota, a sua chave
+ * superestima a prioridade; o voo só é levado para a classe certa quando
+ * chega ao topo da sua (envelhecimento preguiçoso). Como o erro só
+ * superestima, um topo com a taxa certa é de fato o maior da sua classe.
+ */
+
+/**
+ * @brief Retorna o instante atual, em segundos.
+ *
+ * @return double Segundos de um relógio monotônico.
+ */
+static double now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Calcula a taxa de envelhecimento de um voo em um minuto.
+ *
+ * @param flight Voo, com os campos do minuto 0.
+ * @param minute Minuto da simulação.
+ * @return unsigned Quanto a prioridade cresce por minuto (0 a 2).
+ */
+static unsigned aging_rate(const Flight *flight, size_t minute)
+{
+    return (flight->time > minute) + (flight->operation == LANDING && flight->fuel > minute);
+}
+
+/**
+ * @brief Calcula o estado de um voo em um minuto.
+ *
+ * @param flight Voo, com os campos do minuto 0.
+ * @param minute Minuto da simulação.
+ * @return Flight Voo com o combustível, o tempo e a prioridade do minuto.
+ */
+static Flight aged_flight(const Flight *flight, size_t minute)
+{
+    Flight aged = *flight;
+
+    aged.time = flight->time > minute ? (ushort)(flight->time - minute) : 0;
+
+    if (flight->operation == LANDING)
+        aged.fuel = flight->fuel > minute ? (ushort)(flight->fuel - minute) : 0;
+
+    aged.priority = calculate_priority(aged);
+
+    return aged;
+}
+
+/**
+ * @brief Insere um voo na classe da sua taxa atual.
+ *
+ * @param classes Heaps de cada taxa.
+ * @param flight Voo, com os campos do minuto 0.
+ * @param minute Minuto da simulação.
+ * @return true se o voo foi inserido, false caso contrário.
+ */
+static bool classify(Heap *classes[], Flight flight, size_t minute)
+{
+    unsigned rate = aging_rate(&flight, minute);
+
+    // Com taxa positiva, minute < SIMULATION_HORIZON
+    flight.priority = aged_flight(&flight, minute).priority + rate * (SIMULATION_HORIZON - minute);
+
+    return insert(classes[rate], flight);
+}
+
+/**
+ * @brief Retira o voo de maior prioridade em um minuto.
+ *
+ * Antes de comparar as classes, leva para a classe certa os topos cuja taxa
+ * mudou. Em empates entre classes, vence a de maior taxa.
+ *
+ * @param classes Heaps de cada taxa.
+ * @param minute Minuto da simulação.
+ * @param flight Recebe o voo, com os campos do minuto.
+ * @param moves Contador de reclassificações.
+ * @return true se havia voos, false caso contrário.
+ */
+static bool take(Heap *classes[], size_t minute, Flight *flight, size_t *moves)
+{
+    Heap *best = NULL;
+    long best_priority = 0;
+
+    // Das taxas maiores para as menores, para que o voo movido seja revisto na nova classe
+    for (unsigned rate = SIMULATION_CLASSES; rate-- > 0;)
+    {
+        Heap *heap = classes[rate];
+
+        while (heap->size > 0 && aging_rate(top(heap), minute) != rate)
+        {
+            Flight moved = *top(heap);
+
+            pop(heap);
+            classify(classes, moved, minute);
+            (*moves)++;
+        }
+
+        if (heap->size == 0)
+            continue;
+
+        long priority = (long)top(heap)->priority - (long)rate * ((long)SIMULATION_HORIZON - (long)minute);
+
+        if (best == NULL || priority > best_priority)
+        {
+            best = heap;
+            best_priority = priority;
+        }
+    }
+
+    if (best == NULL)
+        return false;
+
+    *flight = aged_flight(top(best), minute);
+    pop(best);
+
+    return true;
+}
+
+/**
+ * @brief Simula o despacho minuto a minuto, com a prioridade dos voos envelhecendo.
+ *
+ * Os voos da heap entram na simulação no minuto 0, com o tempo lido como os
+ * minutos que faltam até o seu horário. A cada minuto simulado, a pista
+ * libera `rate` voos, os de maior prioridade naquele minuto, escritos na
+ * saída padrão como minuto,id,combustivel,tempo,operacao,emergencia,prioridade
+ * (com os valores do minuto). Ao final, a vazão em movimentos simulados por
+ * segundo é informada na saída de erros. A heap não é alterada.
+ *
+ * @param heap Ponteiro para a heap com os voos.
+ * @param rate Quantidade de voos despachados por minuto.
+ * @return true se a simulação foi concluída, false caso contrário.
+ */
+bool run_simulation(Heap *heap, size_t rate)
+{
+    Heap *classes[SIMULATION_CLASSES] = {NULL};
+    Flight *flights = (Flight *)malloc((heap->size > 0 ? heap->size : 1) * sizeof(Flight));
+    bool success = flights != NULL;
+    size_t movements = 0;
+    size_t moves = 0;
+
+    if (rate < 1)
+        rate = 1;
+
+    for (size_t i = 0; i < SIMULATION_CLASSES && success; i++)
+        success = (classes[i] = initialize()) != NULL;
+
+    if (!success)
+        fprintf(stderr, "Memoria insuficiente para a simulacao.\n");
+
+    double start = now();
+
+    // Os voos entram na ordem de despacho, o que mantém os desempates iguais em todas as estruturas
+    size_t count = success ? top_k(heap, heap->size, flights) : 0;
+
+    for (size_t i = 0; i < count && success; i++)
+        success = classify(classes, flights[i], 0);
+
+    free(flights);
+
+    for (size_t minute = 0; success && movements < count; minute++)
+    {
+        Flight movement;
+
+        for (size_t i = 0; i < rate && take(classes, minute, &movement, &moves); i++, movements++)
+        {
+            printf("%zu,", minute);
+            write_flight(stdout, &movement);
+        }
+    }
+
+    double elapsed = now() - start;
+
+    fflush(stdout);
+
+    if (success)
+        fprintf(stderr, "%zu movimentos simulados em %.3f s (%.0f movimentos/s, %zu reclassificacoes).\n",
+                movements, elapsed, elapsed > 0 ? movements / elapsed : 0.0, moves);
+
+    for (size_t i = 0; i < SIMULATION_CLASSES; i++)
+        deallocate(&classes[i]);
+
+    return success;
+}
@@ -0,0 +1,204 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "snapshot.h"
+#include "journal.h"
+
+// Valor inicial do hash FNV-1a (64 bits).
+#define CHECKSUM_BASIS 14695981039346656037u
+
+// Quantidade de voos reunidos por escrita ao gravar um snapshot.
+#define SNAPSHOT_CHUNK 4096
+
+/**
+ * @brief Acumula o hash FNV-1a (64 bits) de um bloco de memória.
+ *
+ * @param hash Hash dos blocos anteriores (CHECKSUM_BASIS no primeiro).
+ * @param data Início do bloco.
+ * @param length Quantidade de bytes.
+ * @return uint64_t Valor do hash.
+ */
+static uint64_t checksum(uint64_t hash, const void *data, size_t length)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211u;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Grava o estado da heap em um arquivo binário.
+ *
+ * O arquivo contém um SnapshotHeader seguido dos voos na ordem de despacho
+ * (ver dispatch_order), reunidos em blocos de SNAPSHOT_CHUNK voos. Essa
+ * ordem é uma heap válida para qualquer estrutura e aridade, e lidos como
+ * chegadas sucessivas, os voos de mesma prioridade mantêm os desempates
+ * da heap gravada. O cabeçalho guarda também a
+ * sequência da última operação do diário, para que apenas as operações
+ * posteriores sejam reaplicadas sobre o snapshot. A gravação é feita em um
+ * arquivo temporário que só substitui o destino depois de completa, de modo
+ * que um snapshot anterior nunca fica corrompido pela metade.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param file_path Caminho do arquivo de destino.
+ * @return true se o snapshot foi gravado, false caso contrário.
+ */
+bool save_snapshot(Heap *heap, const char *file_path)
+{
+    SnapshotHeader header;
+    char temp_path[512];
+    Flight *chunk = (Flight *)malloc(SNAPSHOT_CHUNK * sizeof(Flight));
+    uint32_t *order = dispatch_order(heap);
+
+    if (chunk == NULL || order == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para gravar o snapshot.\n");
+        free(chunk);
+        free(order);
+        return false;
+    }
+
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", file_path) >= (int)sizeof(temp_path))
+    {
+        fprintf(stderr, "Caminho do snapshot muito longo.\n");
+        free(chunk);
+        free(order);
+        return false;
+    }
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.record_size = sizeof(Flight);
+    header.count = heap->size;
+    header.checksum = CHECKSUM_BASIS;
+    header.sequence = journal_sequence(heap->journal);
+
+    FILE *output_file = fopen(temp_path, "wb");
+
+    if (!output_file)
+    {
+        fprintf(stderr, "Unable to write file \"%s\": %s.\n", temp_path, strerror(errno));
+        free(chunk);
+        free(order);
+        return false;
+    }
+
+    // O hash só é conhecido no fim; o cabeçalho é regravado depois dos voos
+    bool success = fwrite(&header, sizeof(header), 1, output_file) == 1;
+
+    for (size_t first = 0; success && first < heap->size; first += SNAPSHOT_CHUNK)
+    {
+        size_t count = heap->size - first < SNAPSHOT_CHUNK ? heap->size - first : SNAPSHOT_CHUNK;
+
+        for (size_t i = 0; i < count; i++)
+            chunk[i] = heap->flights[order[first + i]];
+
+        header.checksum = checksum(header.checksum, chunk, count * sizeof(Flight));
+        success = fwrite(chunk, sizeof(Flight), count, output_file) == count;
+    }
+
+    success = success && fseek(output_file, 0, SEEK_SET) == 0 &&
+              fwrite(&header, sizeof(header), 1, output_file) == 1;
+    success = fclose(output_file) == 0 && success;
+    free(chunk);
+    free(order);
+
+    // No Windows, rename não substitui um arquivo existente
+    if (success && rename(temp_path, file_path) != 0)
+        success = remove(file_path) == 0 && rename(temp_path, file_path) == 0;
+
+    if (!success)
+    {
+        fprintf(stderr, "Unable to write file \"%s\": %s.\n", file_path, strerror(errno));
+        remove(temp_path);
+    }
+
+    return success;
+}
+
+/**
+ * @brief Restaura o estado da heap a partir de um arquivo binário.
+ *
+ * Valida o cabeçalho (identificador, versão e tamanho dos registros), lê
+ * todos os voos com uma única leitura para um novo repositório e confere o
+ * hash. Como os voos estão na ordem de despacho, que é uma heap para
+ * qualquer estrutura, o repositório é adotado sem reordenação; apenas os nós
+ * e o índice de IDs são reconstruídos, com a ordem de chegada dada pela
+ * posição de cada voo. Em caso de erro, a heap não é alterada.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param file_path Caminho do snapshot.
+ * @param sequence Recebe a sequência do diário gravada no snapshot (pode ser NULL).
+ * @return true se o snapshot foi restaurado, false caso contrário.
+ */
+bool load_snapshot(Heap *heap, const char *file_path, uint64_t *sequence)
+{
+    SnapshotHeader header;
+    FILE *input_file = fopen(file_path, "rb");
+
+    if (!input_file)
+    {
+        fprintf(stderr, "Unable to read file \"%s\": %s.\n", file_path, strerror(errno));
+        return false;
+    }
+
+    if (fread(&header, sizeof(header), 1, input_file) != 1 ||
+        memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "\"%s\" nao e um snapshot valido.\n", file_path);
+        fclose(input_file);
+        return false;
+    }
+
+    if (header.version != SNAPSHOT_VERSION || header.record_size != sizeof(Flight))
+    {
+        fprintf(stderr, "Snapshot \"%s\" incompativel (versao %u).\n", file_path, (unsigned)header.version);
+        fclose(input_file);
+        return false;
+    }
+
+    // O novo repositório segue a mesma política de capacidade da heap
+    size_t capacity = INITIAL_CAPACITY;
+    Flight *data = NULL;
+
+    if (header.count <= SIZE_MAX / (4 * sizeof(Flight)))
+    {
+        while (capacity < header.count)
+            capacity *= 2;
+
+        data = (Flight *)malloc(capacity * sizeof(Flight));
+    }
+
+    if (data == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para ler \"%s\".\n", file_path);
+        fclose(input_file);
+        return false;
+    }
+
+    size_t count = (size_t)header.count;
+    bool success = fread(data, sizeof(Flight), count, input_file) == count &&
+                   checksum(CHECKSUM_BASIS, data, count * sizeof(Flight)) == header.checksum;
+
+    fclose(input_file);
+
+    if (!success)
+        fprintf(stderr, "Snapshot \"%s\" corrompido.\n", file_path);
+    else if (!(success = adopt_flights(heap, data, count, capacity)))
+        fprintf(stderr, "Memoria insuficiente para ler \"%s\".\n", file_path);
+
+    if (!success)
+        free(data);
+    else if (sequence != NULL)
+        *sequence = header.sequence;
+
+    return success;
+}
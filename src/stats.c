@@ -0,0 +1,203 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <time.h>
+
+#include "stats.h"
+#include "flight.h"
+
+// Nome de cada operação no relatório (índice StatsOp).
+static const char *const OP_NAMES[STATS_OPS] = {"insert", "pop", "excluir", "edit", "heapify", "outras"};
+
+/**
+ * @brief Retorna o instante atual, em nanossegundos.
+ *
+ * @return double Nanossegundos de um relógio monotônico.
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Inicializa os contadores.
+ *
+ * Todos os contadores são zerados e as contagens feitas fora das operações
+ * instrumentadas passam a ir para STATS_OTHER.
+ *
+ * @param stats Contadores.
+ */
+void stats_reset(HeapStats *stats)
+{
+    memset(stats, 0, sizeof(HeapStats));
+    stats->current = STATS_OTHER;
+}
+
+/**
+ * @brief Começa a medir uma operação e retorna o instante inicial.
+ *
+ * @param stats Contadores.
+ * @param op Operação que recebe as contagens até stats_end.
+ * @return double Instante inicial, em nanossegundos.
+ */
+double stats_begin(HeapStats *stats, StatsOp op)
+{
+    stats->current = op;
+
+    return now_ns();
+}
+
+/**
+ * @brief Conclui a medição iniciada por stats_begin.
+ *
+ * Conta a chamada, registra a latência no histograma (faixa b: até 2^b ns)
+ * e, se houver um período definido, escreve o relatório na saída de erros a
+ * cada `period` chamadas. Chamadas que falham terminam em STATS_CANCEL e não
+ * são contadas.
+ *
+ * @param stats Contadores.
+ * @param start Instante retornado por stats_begin.
+ */
+void stats_end(HeapStats *stats, double start)
+{
+    uint64_t elapsed = (uint64_t)(now_ns() - start);
+    size_t bucket = 0;
+
+    while (bucket < STATS_BUCKETS - 1 && (UINT64_C(1) << bucket) < elapsed)
+        bucket++;
+
+    stats->latency[stats->current][bucket]++;
+    stats->calls[stats->current]++;
+    stats->current = STATS_OTHER;
+    stats->operations++;
+
+    if (stats->period > 0 && stats->operations % stats->period == 0)
+        stats_print(stderr, stats);
+}
+
+/**
+ * @brief Conta um valor em um histograma de faixas unitárias.
+ *
+ * Valores a partir de STATS_BUCKETS - 1 vão para a última faixa.
+ *
+ * @param histogram Histograma.
+ * @param value Valor.
+ */
+void stats_sample(uint64_t *histogram, size_t value)
+{
+    histogram[value < STATS_BUCKETS - 1 ? value : STATS_BUCKETS - 1]++;
+}
+
+/**
+ * @brief Calcula um percentil de um histograma.
+ *
+ * @param histogram Histograma.
+ * @param percentile Percentil, entre 0 e 1.
+ * @return size_t Faixa que contém o percentil (0 se o histograma estiver vazio).
+ */
+static size_t histogram_percentile(const uint64_t *histogram, double percentile)
+{
+    uint64_t total = 0;
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < STATS_BUCKETS; i++)
+        total += histogram[i];
+
+    for (size_t i = 0; i < STATS_BUCKETS; i++)
+        if ((seen += histogram[i]) > 0 && seen >= percentile * total)
+            return i;
+
+    return 0;
+}
+
+/**
+ * @brief Calcula a média de um histograma de faixas unitárias.
+ *
+ * @param histogram Histograma.
+ * @return double Média dos valores (a última faixa conta como STATS_BUCKETS - 1).
+ */
+static double histogram_mean(const uint64_t *histogram)
+{
+    uint64_t total = 0;
+    uint64_t sum = 0;
+
+    for (size_t i = 0; i < STATS_BUCKETS; i++)
+    {
+        total += histogram[i];
+        sum += i * histogram[i];
+    }
+
+    return total > 0 ? (double)sum / total : 0.0;
+}
+
+/**
+ * @brief Escreve os contadores e histogramas.
+ *
+ * Uma linha por operação: chamadas, comparações e movimentos por chamada,
+ * profundidade média e máxima (p100) dos ajustes, entradas lidas por busca
+ * no índice e os percentis 50 e 99 da latência (limite superior da faixa).
+ *
+ * @param stream Fluxo de saída.
+ * @param stats Contadores.
+ */
+void stats_print(FILE *stream, const HeapStats *stats)
+{
+    fprintf(stream, "%-8s %12s %10s %10s %8s %8s %8s %10s %10s\n", "operacao", "chamadas", "comp/op",
+            "movim/op", "niveis", "max_niv", "sondagem", "p50_ns", "p99_ns");
+
+    for (size_t op = 0; op < STATS_OPS; op++)
+    {
+        double calls = stats->calls[op] > 0 ? (double)stats->calls[op] : 1.0;
+        bool timed = op != STATS_OTHER && stats->calls[op] > 0;
+
+        fprintf(stream, "%-8s %12llu %10.1f %10.1f %8.2f %8zu %8.2f %10.0f %10.0f\n", OP_NAMES[op],
+                (unsigned long long)stats->calls[op], stats->comparisons[op] / calls, stats->moves[op] / calls,
+                histogram_mean(stats->depth[op]), histogram_percentile(stats->depth[op], 1.0),
+                histogram_mean(stats->probes[op]),
+                timed ? (double)(UINT64_C(1) << histogram_percentile(stats->latency[op], 0.5)) : 0.0,
+                timed ? (double)(UINT64_C(1) << histogram_percentile(stats->latency[op], 0.99)) : 0.0);
+    }
+
+    fflush(stream);
+}
+
+/**
+ * @brief Escreve as estatísticas de instrumentação da heap.
+ *
+ * Sem HEAP_STATS, apenas informa como ativá-las.
+ *
+ * @param stream Fluxo de saída.
+ * @param heap Ponteiro para a heap.
+ */
+void print_stats(FILE *stream, Heap *heap)
+{
+#if HEAP_STATS
+    stats_print(stream, &heap->stats);
+#else
+    (void)heap;
+    fprintf(stream, "Estatisticas desativadas; compile com -DHEAP_STATS=1.\n");
+#endif
+}
+
+/**
+ * @brief Define de quantas em quantas operações as estatísticas são escritas.
+ *
+ * O relatório vai para a saída de erros a cada `period` operações
+ * instrumentadas concluídas (0 desativa). Sem HEAP_STATS, não tem efeito.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param period Operações entre relatórios.
+ */
+void set_stats_period(Heap *heap, uint64_t period)
+{
+#if HEAP_STATS
+    heap->stats.period = period;
+#else
+    (void)heap;
+    (void)period;
+#endif
+}
@@ -0,0 +1,173 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define read _read
+#define fileno _fileno
+#else
+#include <unistd.h>
+#endif
+
+#include "stream.h"
+#include "csv.h"
+
+/**
+ * @brief Despacha até `count` voos, escrevendo-os na saída padrão.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param count Quantidade máxima de voos a despachar.
+ */
+static void dispatch(Heap *heap, size_t count)
+{
+    Flight flights[STREAM_DISPATCH_CHUNK];
+
+    // Retira os voos em grupos (ver pop_k), para que a heap encolha uma vez por grupo
+    while (count > 0 && heap->size > 0)
+    {
+        size_t released = pop_k(heap, count < STREAM_DISPATCH_CHUNK ? count : STREAM_DISPATCH_CHUNK, flights);
+
+        for (size_t i = 0; i < released; i++)
+            write_flight(stdout, &flights[i]);
+
+        count -= released;
+    }
+}
+
+/**
+ * @brief Consome um fluxo de voos e emite a ordem de despacho.
+ *
+ * Lê da entrada linhas no mesmo formato dos arquivos CSV, em blocos de até
+ * STREAM_CHUNK_SIZE bytes, e insere cada voo na heap. Cada leitura devolve o
+ * que já chegou, sem esperar o bloco encher, e a saída é esvaziada antes de
+ * cada leitura, de modo que, em um fluxo ao vivo, os despachos aparecem
+ * assim que a entrada para de chegar. A cada `tick` linhas lidas, a pista
+ * libera `rate` voos (os de maior prioridade no momento), escritos em CSV
+ * na saída padrão (ver write_flight). Ao fim da entrada, os voos restantes
+ * são despachados em ordem. Apenas os voos ainda não despachados ficam em
+ * memória, já que a arena da heap encolhe à medida que ela esvazia. Linhas
+ * inválidas ou longas demais são informadas com seu número e ignoradas.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param input Fluxo de entrada.
+ * @param rate Quantidade de voos despachados a cada intervalo.
+ * @param tick Quantidade de linhas lidas por intervalo.
+ * @return true se a entrada foi consumida sem erros, false caso contrário.
+ */
+bool run_stream(Heap *heap, FILE *input, size_t rate, size_t tick)
+{
+    char *buffer = (char *)malloc(STREAM_CHUNK_SIZE);
+
+    if (buffer == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para ler a entrada.\n");
+        return false;
+    }
+
+    size_t pending = 0;      // Bytes de uma linha incompleta no início do buffer
+    size_t line_number = 0;
+    size_t errors = 0;
+    bool skipping = false;   // Descartando o restante de uma linha longa demais
+    bool eof = false;
+    Flight flight;
+
+    if (tick < 1)
+        tick = 1;
+
+    while (!eof)
+    {
+        // Entrega os voos já despachados antes de esperar por mais entrada
+        fflush(stdout);
+
+        long received = (long)read(fileno(input), buffer + pending, STREAM_CHUNK_SIZE - pending);
+
+        if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            fprintf(stderr, "Falha ao ler a entrada: %s.\n", strerror(errno));
+            errors++;
+            break;
+        }
+
+        eof = received == 0;
+
+        const char *end = buffer + pending + received;
+        const char *line = buffer;
+
+        if (skipping)
+        {
+            const char *eol = (const char *)memchr(line, '\n', (size_t)(end - line));
+
+            // O bloco inteiro ainda faz parte da linha longa demais
+            if (eol == NULL)
+                continue;
+
+            skipping = false;
+            line = eol + 1;
+        }
+
+        while (line < end)
+        {
+            const char *eol = (const char *)memchr(line, '\n', (size_t)(end - line));
+
+            // Uma linha incompleta só é processada no fim da entrada
+            if (eol == NULL && !eof)
+                break;
+
+            if (eol == NULL)
+                eol = end;
+
+            line_number++;
+
+            // Ignora linhas vazias
+            if (eol > line && !(eol - line == 1 && *line == '\r'))
+            {
+                const char *error = parse_flight(line, eol, &flight);
+
+                if (error == NULL)
+                    insert(heap, flight);
+                else
+                {
+                    fprintf(stderr, "stdin:%zu: %s.\n", line_number, error);
+                    errors++;
+                }
+            }
+
+            if (line_number % tick == 0)
+                dispatch(heap, rate);
+
+            line = eol + 1;
+        }
+
+        // Move a linha incompleta para o início do buffer
+        pending = line < end ? (size_t)(end - line) : 0;
+
+        // Uma linha que não cabe no buffer é descartada até o seu fim
+        if (pending == STREAM_CHUNK_SIZE)
+        {
+            fprintf(stderr, "stdin:%zu: linha longa demais.\n", ++line_number);
+            errors++;
+            pending = 0;
+            skipping = true;
+
+            if (line_number % tick == 0)
+                dispatch(heap, rate);
+        }
+
+        memmove(buffer, line, pending);
+    }
+
+    // Despacha todos os voos restantes
+    dispatch(heap, heap->size);
+
+    fflush(stdout);
+    free(buffer);
+
+    return errors == 0;
+}
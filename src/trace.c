@@ -0,0 +1,199 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "trace.h"
+
+// Rastro das operações de uma heap.
+struct Trace
+{
+    FILE *file;         //! Arquivo do rastro.
+    char *buffer;       //! Buffer de gravação do arquivo.
+    double start;       //! Instante da abertura, em nanossegundos.
+};
+
+/**
+ * @brief Retorna o instante atual, em nanossegundos.
+ *
+ * @return double Nanossegundos de um relógio monotônico.
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/**
+ * @brief Abre um rastro, começando pelo conteúdo atual da heap.
+ *
+ * O arquivo é criado (ou truncado) e recebe o cabeçalho e um registro
+ * TRACE_STATE com os voos da heap, de modo que o rastro possa ser
+ * reproduzido a partir de uma heap vazia. Os registros seguintes são
+ * acumulados em um buffer de TRACE_BUFFER_SIZE bytes antes de irem ao disco.
+ *
+ * @param file_path Caminho do rastro.
+ * @param heap Heap cujas operações serão registradas.
+ * @return Trace* Rastro aberto ou NULL em caso de erro.
+ */
+Trace *trace_open(const char *file_path, Heap *heap)
+{
+    Trace *trace = (Trace *)calloc(1, sizeof(Trace));
+    TraceHeader header;
+
+    if (trace == NULL || (trace->buffer = (char *)malloc(TRACE_BUFFER_SIZE)) == NULL)
+    {
+        fprintf(stderr, "Memoria insuficiente para o rastro.\n");
+        free(trace);
+        return NULL;
+    }
+
+    trace->file = fopen(file_path, "wb");
+
+    if (!trace->file)
+    {
+        fprintf(stderr, "Unable to write file \"%s\": %s.\n", file_path, strerror(errno));
+        free(trace->buffer);
+        free(trace);
+        return NULL;
+    }
+
+    setvbuf(trace->file, trace->buffer, _IOFBF, TRACE_BUFFER_SIZE);
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.record_size = sizeof(TraceRecord);
+    header.flight_size = sizeof(Flight);
+
+    fwrite(&header, sizeof(header), 1, trace->file);
+
+    trace->start = now_ns();
+    trace_record_heap(trace, TRACE_STATE, heap);
+
+    return trace;
+}
+
+/**
+ * @brief Registra uma operação no rastro.
+ *
+ * @param trace Rastro (se NULL, nada é feito).
+ * @param op Tipo de operação.
+ * @param flight Voo da operação (apenas TRACE_INSERT, TRACE_UPDATE e TRACE_DELETE; NULL nas demais).
+ * @param count k de TRACE_POP_K e TRACE_TOP_K (0 nas demais).
+ */
+void trace_record(Trace *trace, TraceOp op, const Flight *flight, size_t count)
+{
+    if (trace == NULL)
+        return;
+
+    TraceRecord record;
+
+    record.time = (uint64_t)(now_ns() - trace->start);
+    record.op = op;
+    record.count = (uint32_t)count;
+
+    fwrite(&record, sizeof(record), 1, trace->file);
+
+    if (flight != NULL)
+        fwrite(flight, sizeof(Flight), 1, trace->file);
+}
+
+/**
+ * @brief Registra uma operação que carrega todos os voos de uma heap.
+ *
+ * Usada para TRACE_STATE (o novo conteúdo da heap) e TRACE_MERGE (os voos
+ * da heap de origem).
+ *
+ * @param trace Rastro (se NULL, nada é feito).
+ * @param op TRACE_STATE ou TRACE_MERGE.
+ * @param heap Heap com os voos.
+ */
+void trace_record_heap(Trace *trace, TraceOp op, Heap *heap)
+{
+    if (trace == NULL)
+        return;
+
+    size_t cursor = 0;
+    Flight *flight;
+
+    trace_record(trace, op, NULL, heap->size);
+
+    while ((flight = next_flight(heap, &cursor)) != NULL)
+        fwrite(flight, sizeof(Flight), 1, trace->file);
+}
+
+/**
+ * @brief Grava os registros pendentes e fecha o rastro.
+ *
+ * @param trace Ponteiro para o ponteiro do rastro (pode apontar para NULL).
+ */
+void trace_close(Trace **trace)
+{
+    if (*trace == NULL)
+        return;
+
+    if (fclose((*trace)->file) != 0)
+        fprintf(stderr, "Falha ao gravar o rastro: %s.\n", strerror(errno));
+
+    free((*trace)->buffer);
+    free(*trace);
+    *trace = NULL;
+}
+
+/**
+ * @brief Retorna a quantidade de voos que seguem um registro.
+ *
+ * @param record Registro.
+ * @return size_t 1 para inserções, atualizações e remoções por código,
+ *         `count` para TRACE_STATE e TRACE_MERGE e 0 para as demais.
+ */
+size_t trace_payload(const TraceRecord *record)
+{
+    switch (record->op)
+    {
+    case TRACE_INSERT:
+    case TRACE_UPDATE:
+    case TRACE_DELETE:
+        return 1;
+    case TRACE_STATE:
+    case TRACE_MERGE:
+        return record->count;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Lê e valida o cabeçalho de um rastro.
+ *
+ * @param file Arquivo aberto no início.
+ * @param file_path Caminho do arquivo (para as mensagens de erro).
+ * @return true se o cabeçalho é válido, false caso contrário.
+ */
+bool trace_read_header(FILE *file, const char *file_path)
+{
+    TraceHeader header;
+
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0)
+    {
+        fprintf(stderr, "\"%s\" nao e um rastro valido.\n", file_path);
+        return false;
+    }
+
+    if (header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord) ||
+        header.flight_size != sizeof(Flight))
+    {
+        fprintf(stderr, "Rastro \"%s\" gravado em um formato incompativel.\n", file_path);
+        return false;
+    }
+
+    return true;
+}
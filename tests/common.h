@@ -0,0 +1,59 @@
+#ifndef TESTS_COMMON_H
+#define TESTS_COMMON_H
+
+#include <string.h>
+
+#include "flight.h"
+#include "random.h"
+
+// Rodadas padrão (uma semente por rodada).
+#define DEFAULT_ROUNDS 200
+// Operações por rodada.
+#define OPERATIONS 5000
+// Códigos distintos sorteados, para que remoções e edições encontrem voos.
+#define KEYS 1024
+// Quantidade de estruturas comparadas.
+#define ENGINES 3
+
+// Estruturas comparadas, com a heap binária como referência.
+static const Engine engines[ENGINES] = {ENGINE_BINARY, ENGINE_BUCKET, ENGINE_PAIRING};
+// Nomes das estruturas, para as mensagens de divergência.
+static const char *const engine_names[ENGINES] = {"binary", "bucket", "pairing"};
+
+/**
+ * @brief Sorteia um voo com poucas prioridades distintas, para forçar empates.
+ *
+ * @param state Estado do gerador.
+ * @param key Código do voo.
+ * @return Flight Voo sorteado, com a prioridade calculada.
+ */
+static inline Flight random_flight(uint64_t *state, FlightKey key)
+{
+    uint64_t fields = next_random(state);
+    Flight flight;
+
+    memset(&flight, 0, sizeof(flight));
+    flight.id = key;
+    flight.fuel = (ushort)(MAX_FUEL - fields % 8);
+    flight.time = (ushort)(MAX_TIME - (fields >> 8) % 8);
+    flight.operation = (Operation)((fields >> 16) & 1);
+    flight.emergency = (ushort)((fields >> 24) % 16 == 0);
+    flight.priority = (ushort)calculate_priority(flight);
+
+    return flight;
+}
+
+/**
+ * @brief Compara dois voos campo a campo.
+ *
+ * @param a Primeiro voo.
+ * @param b Segundo voo.
+ * @return true se os voos são iguais.
+ */
+static inline bool same_flight(const Flight *a, const Flight *b)
+{
+    return a->id == b->id && a->fuel == b->fuel && a->time == b->time && a->operation == b->operation &&
+           a->emergency == b->emergency && a->priority == b->priority;
+}
+
+#endif
@@ -0,0 +1,132 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+/**
+ * @brief Compara o tamanho e o topo de cada estrutura com os da heap binária.
+ *
+ * @param heaps Heaps das estruturas.
+ * @return int Índice da primeira estrutura divergente ou -1 se todas concordam.
+ */
+static int compare_heaps(Heap *heaps[ENGINES])
+{
+    for (int engine = 1; engine < ENGINES; engine++)
+    {
+        // top avisa quando a heap está vazia; só é consultado com voos
+        if (heaps[engine]->size != heaps[0]->size)
+            return engine;
+
+        if (heaps[0]->size > 0 && !same_flight(top(heaps[engine]), top(heaps[0])))
+            return engine;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Executa uma rodada de operações sorteadas nas três estruturas.
+ *
+ * Cada operação (inserção, remoção do topo, remoção por código ou edição) é
+ * aplicada às heaps das três estruturas, e os voos devolvidos, o topo e o
+ * tamanho de cada uma são comparados com os da heap binária. Ao final, as
+ * heaps são esvaziadas pelo topo.
+ *
+ * @param seed Semente da rodada.
+ * @return true se as estruturas concordaram em todas as operações.
+ */
+static bool run_round(uint64_t seed)
+{
+    uint64_t state = seed;
+    Heap *heaps[ENGINES];
+    int diverged = -1;
+    bool success = true;
+
+    for (int engine = 0; engine < ENGINES; engine++)
+    {
+        set_heap_engine(engines[engine]);
+        heaps[engine] = initialize();
+        success = success && heaps[engine] != NULL;
+    }
+
+    for (size_t i = 0; success && i < OPERATIONS + KEYS; i++)
+    {
+        FlightKey key = (FlightKey)(next_random(&state) % KEYS + 1);
+        bool found = find_flight(heaps[0], key) != NULL;
+        unsigned choice = (unsigned)(next_random(&state) % 100);
+
+        // Depois das operações sorteadas, só remove do topo até esvaziar
+        if (i >= OPERATIONS)
+            choice = 60;
+
+        if (choice < 40 && !found)
+        {
+            Flight flight = random_flight(&state, key);
+
+            for (int engine = 0; success && engine < ENGINES; engine++)
+                success = insert(heaps[engine], flight);
+        }
+        else if (choice < 70)
+        {
+            if (heaps[0]->size == 0)
+                continue;
+
+            for (int engine = 0; engine < ENGINES; engine++)
+                pop(heaps[engine]);
+        }
+        else if (choice < 85)
+        {
+            Flight expected;
+            Flight removed;
+
+            // A heap vazia recusa a remoção com uma mensagem, sem consultar o código
+            if (heaps[0]->size == 0)
+                continue;
+
+            for (int engine = 0; success && engine < ENGINES; engine++)
+            {
+                success = excluir(heaps[engine], key, engine == 0 ? &expected : &removed) == found;
+
+                if (success && found && engine > 0 && !same_flight(&removed, &expected))
+                    diverged = engine;
+            }
+        }
+        else
+        {
+            Flight fields = random_flight(&state, key);
+
+            for (int engine = 0; success && engine < ENGINES; engine++)
+                success = update_flight(heaps[engine], key, fields) == found;
+        }
+
+        if (diverged < 0)
+            diverged = compare_heaps(heaps);
+
+        success = success && diverged < 0;
+
+        if (!success)
+            fprintf(stderr, "Semente %llu: %s divergiu na operacao %zu.\n", (unsigned long long)seed,
+                    engine_names[diverged < 0 ? 0 : diverged], i);
+    }
+
+    for (int engine = 0; engine < ENGINES; engine++)
+        if (heaps[engine] != NULL)
+            deallocate(&heaps[engine]);
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t rounds = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_ROUNDS;
+    size_t failures = 0;
+
+    for (size_t round = 1; round <= rounds; round++)
+        if (!run_round(round))
+            failures++;
+
+    printf("engines (binary, bucket, pairing): %zu rodadas, %zu falhas\n", rounds, failures);
+
+    return failures == 0 ? 0 : 1;
+}
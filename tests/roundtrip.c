@@ -0,0 +1,240 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+#include "journal.h"
+#include "snapshot.h"
+
+// Prefixo padrão dos arquivos gravados pelo teste.
+#define DEFAULT_PREFIX "roundtrip"
+// Janela de agrupamento do diário, em milissegundos.
+#define COMMIT_WINDOW 10
+
+/**
+ * @brief Aplica a uma heap uma sequência sorteada de operações.
+ *
+ * Inserções, remoções do topo, remoções por código e edições, com muitas
+ * prioridades empatadas, de modo que a ordem de chegada decida boa parte
+ * dos despachos.
+ *
+ * @param heap Ponteiro para a heap.
+ * @param seed Semente da sequência.
+ */
+static void fill(Heap *heap, uint64_t seed)
+{
+    uint64_t state = seed;
+    Flight removed;
+
+    for (size_t i = 0; i < OPERATIONS; i++)
+    {
+        FlightKey key = (FlightKey)(next_random(&state) % KEYS + 1);
+        bool found = find_flight(heap, key) != NULL;
+        unsigned choice = (unsigned)(next_random(&state) % 100);
+
+        // A heap vazia avisa em pop e excluir; só recebe inserções
+        if (choice < 50 && !found)
+            insert(heap, random_flight(&state, key));
+        else if (choice < 50 || heap->size == 0)
+            continue;
+        else if (choice < 65)
+            pop(heap);
+        else if (choice < 80)
+            excluir(heap, key, &removed);
+        else
+            update_flight(heap, key, random_flight(&state, key));
+    }
+}
+
+/**
+ * @brief Esvazia uma heap e confere a ordem de despacho.
+ *
+ * @param heap Ponteiro para a heap (liberada ao final).
+ * @param expected Voos esperados, na ordem de despacho.
+ * @param count Quantidade de voos esperados.
+ * @return true se a heap devolveu exatamente os voos esperados, na mesma ordem.
+ */
+static bool drain_matches(Heap *heap, const Flight *expected, size_t count)
+{
+    Flight *flights = (Flight *)malloc((count > 0 ? count : 1) * sizeof(Flight));
+    bool success = flights != NULL && heap->size == count && pop_k(heap, count, flights) == count;
+
+    for (size_t i = 0; success && i < count; i++)
+        success = same_flight(&flights[i], &expected[i]);
+
+    free(flights);
+    deallocate(&heap);
+
+    return success;
+}
+
+/**
+ * @brief Grava um snapshot de cada estrutura e o restaura em todas elas.
+ *
+ * A ordem de despacho da heap restaurada, em qualquer estrutura, deve ser
+ * a mesma da heap gravada, inclusive entre voos de mesma prioridade.
+ *
+ * @param seed Semente da rodada.
+ * @param path Caminho do snapshot.
+ * @return true se todas as restaurações despacharam na ordem da heap gravada.
+ */
+static bool snapshot_round(uint64_t seed, const char *path)
+{
+    bool success = true;
+
+    for (int saved = 0; success && saved < ENGINES; saved++)
+    {
+        Flight *expected = NULL;
+        size_t count = 0;
+
+        set_heap_engine(engines[saved]);
+
+        Heap *heap = initialize();
+
+        success = heap != NULL;
+
+        if (success)
+        {
+            fill(heap, seed);
+            success = save_snapshot(heap, path) &&
+                      (expected = (Flight *)malloc((heap->size > 0 ? heap->size : 1) * sizeof(Flight))) != NULL;
+            count = success ? pop_k(heap, heap->size, expected) : 0;
+            deallocate(&heap);
+        }
+
+        for (int loaded = 0; success && loaded < ENGINES; loaded++)
+        {
+            set_heap_engine(engines[loaded]);
+
+            Heap *restored = initialize();
+
+            success = restored != NULL && load_snapshot(restored, path, NULL) &&
+                      drain_matches(restored, expected, count);
+
+            if (!success)
+                fprintf(stderr, "Semente %llu: snapshot de %s restaurado em %s divergiu.\n",
+                        (unsigned long long)seed, engine_names[saved], engine_names[loaded]);
+        }
+
+        free(expected);
+    }
+
+    remove(path);
+
+    return success;
+}
+
+/**
+ * @brief Cria uma heap com voos sorteados, de códigos acima de KEYS.
+ *
+ * Os códigos não se repetem entre si nem com os de fill, e a quantidade
+ * varia com a semente, de modo que a união ora copia a origem, ora troca o
+ * conteúdo das heaps.
+ *
+ * @param seed Semente do lote.
+ * @return Heap* Heap com o lote ou NULL se a alocação falhar.
+ */
+static Heap *random_batch(uint64_t seed)
+{
+    uint64_t state = seed;
+    size_t count = (size_t)(next_random(&state) % KEYS);
+    Heap *batch = initialize();
+
+    for (size_t i = 0; batch != NULL && i < count; i++)
+        insert(batch, random_flight(&state, (FlightKey)(KEYS + 1 + i)));
+
+    return batch;
+}
+
+/**
+ * @brief Registra operações e uma união de heaps em um diário e o reaplica em todas as estruturas.
+ *
+ * A heap de cada estrutura recebe uma sequência sorteada de operações, um
+ * lote unido por heap_merge (como no IMPORT) e mais operações, tudo com o
+ * diário aberto. A ordem de despacho da heap reconstruída a partir do
+ * diário, em qualquer estrutura, deve ser a mesma da heap original.
+ *
+ * @param seed Semente da rodada.
+ * @param path Caminho do diário.
+ * @return true se todas as reconstruções despacharam na ordem da heap original.
+ */
+static bool journal_round(uint64_t seed, const char *path)
+{
+    bool success = true;
+
+    for (int recorded = 0; success && recorded < ENGINES; recorded++)
+    {
+        Flight *expected = NULL;
+        size_t count = 0;
+        uint64_t sequence = 0;
+
+        remove(path);
+        set_heap_engine(engines[recorded]);
+
+        Heap *heap = initialize();
+        Heap *batch = random_batch(seed);
+
+        success = heap != NULL && batch != NULL &&
+                  (heap->journal = journal_open(path, sequence, COMMIT_WINDOW)) != NULL;
+
+        if (success)
+        {
+            fill(heap, seed);
+            success = heap_merge(heap, batch);
+            fill(heap, seed + 1);
+
+            // Fecha o diário antes de esvaziar a heap, para que as retiradas não sejam registradas
+            journal_close(&heap->journal);
+            success = success &&
+                      (expected = (Flight *)malloc((heap->size > 0 ? heap->size : 1) * sizeof(Flight))) != NULL;
+            count = success ? pop_k(heap, heap->size, expected) : 0;
+        }
+
+        if (heap != NULL)
+            deallocate(&heap);
+
+        if (batch != NULL)
+            deallocate(&batch);
+
+        for (int replayed = 0; success && replayed < ENGINES; replayed++)
+        {
+            set_heap_engine(engines[replayed]);
+
+            Heap *restored = initialize();
+
+            sequence = 0;
+            success = restored != NULL && journal_replay(restored, path, &sequence) &&
+                      drain_matches(restored, expected, count);
+
+            if (!success)
+                fprintf(stderr, "Semente %llu: diario de %s reaplicado em %s divergiu.\n",
+                        (unsigned long long)seed, engine_names[recorded], engine_names[replayed]);
+        }
+
+        free(expected);
+    }
+
+    remove(path);
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t rounds = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_ROUNDS;
+    const char *prefix = argc > 2 ? argv[2] : DEFAULT_PREFIX;
+    char snapshot_path[512];
+    char journal_path[512];
+    size_t failures = 0;
+
+    snprintf(snapshot_path, sizeof(snapshot_path), "%s.snapshot", prefix);
+    snprintf(journal_path, sizeof(journal_path), "%s.journal", prefix);
+
+    for (size_t round = 1; round <= rounds; round++)
+        if (!snapshot_round(round, snapshot_path) || !journal_round(round, journal_path))
+            failures++;
+
+    printf("roundtrip (snapshot, diario e uniao): %zu rodadas, %zu falhas\n", rounds, failures);
+
+    return failures == 0 ? 0 : 1;
+}
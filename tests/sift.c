@@ -0,0 +1,244 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "common.h"
+
+// Heap de referência: a implementação anterior, recursiva e com trocas.
+typedef struct
+{
+    Flight *flights;        //! Voos organizados como heap.
+    uint32_t *arrivals;     //! Ordem de chegada de cada voo (desempata prioridades iguais).
+    size_t size;            //! Quantidade de voos.
+    uint32_t next_arrival;  //! Ordem de chegada do próximo voo.
+} Reference;
+
+/**
+ * @brief Indica se o voo `a` sai antes do voo `b` na heap de referência.
+ *
+ * @param reference Heap de referência.
+ * @param a Posição do primeiro voo.
+ * @param b Posição do segundo voo.
+ * @return true se `a` tem prioridade maior ou, empatado, chegou antes.
+ */
+static bool reference_before(const Reference *reference, size_t a, size_t b)
+{
+    if (reference->flights[a].priority != reference->flights[b].priority)
+        return reference->flights[a].priority > reference->flights[b].priority;
+
+    return reference->arrivals[a] < reference->arrivals[b];
+}
+
+/**
+ * @brief Troca dois voos de posição na heap de referência.
+ *
+ * @param reference Heap de referência.
+ * @param a Posição do primeiro voo.
+ * @param b Posição do segundo voo.
+ */
+static void reference_swap(Reference *reference, size_t a, size_t b)
+{
+    Flight flight = reference->flights[a];
+    uint32_t arrival = reference->arrivals[a];
+
+    reference->flights[a] = reference->flights[b];
+    reference->arrivals[a] = reference->arrivals[b];
+    reference->flights[b] = flight;
+    reference->arrivals[b] = arrival;
+}
+
+/**
+ * @brief Desce um voo, trocando-o com o maior filho (recursiva).
+ *
+ * @param reference Heap de referência.
+ * @param idx Posição do voo.
+ */
+static void reference_heapify(Reference *reference, size_t idx)
+{
+    size_t largest = idx;
+
+    for (size_t child = HEAP_ARITY * idx + 1; child <= HEAP_ARITY * idx + HEAP_ARITY && child < reference->size;
+         child++)
+        if (reference_before(reference, child, largest))
+            largest = child;
+
+    if (largest != idx)
+    {
+        reference_swap(reference, idx, largest);
+        reference_heapify(reference, largest);
+    }
+}
+
+/**
+ * @brief Sobe um voo, trocando-o com o pai.
+ *
+ * @param reference Heap de referência.
+ * @param idx Posição do voo.
+ */
+static void reference_sift_up(Reference *reference, size_t idx)
+{
+    while (idx > 0 && reference_before(reference, idx, (idx - 1) / HEAP_ARITY))
+    {
+        reference_swap(reference, idx, (idx - 1) / HEAP_ARITY);
+        idx = (idx - 1) / HEAP_ARITY;
+    }
+}
+
+/**
+ * @brief Busca um voo pelo código (linear).
+ *
+ * @param reference Heap de referência.
+ * @param key Código do voo.
+ * @return size_t Posição do voo ou reference->size se não houver voo com o código.
+ */
+static size_t reference_find(const Reference *reference, FlightKey key)
+{
+    size_t idx = 0;
+
+    while (idx < reference->size && reference->flights[idx].id != key)
+        idx++;
+
+    return idx;
+}
+
+/**
+ * @brief Remove o voo de uma posição, movendo o último para ela.
+ *
+ * @param reference Heap de referência.
+ * @param idx Posição do voo.
+ * @return Flight Voo removido.
+ */
+static Flight reference_remove(Reference *reference, size_t idx)
+{
+    Flight removed = reference->flights[idx];
+
+    reference_swap(reference, idx, --reference->size);
+
+    if (idx < reference->size)
+    {
+        reference_sift_up(reference, idx);
+        reference_heapify(reference, idx);
+    }
+
+    return removed;
+}
+
+/**
+ * @brief Executa uma rodada de operações sorteadas nas duas heaps.
+ *
+ * Cada operação (inserção, remoção do topo, remoção por código ou edição) é
+ * aplicada à heap da biblioteca e à de referência, e os voos devolvidos são
+ * comparados. Ao final, as duas heaps são esvaziadas e comparadas voo a voo.
+ *
+ * @param seed Semente da rodada.
+ * @return true se as heaps concordaram em todas as operações.
+ */
+static bool run_round(uint64_t seed)
+{
+    uint64_t state = seed;
+    Heap *heap = initialize();
+    Reference reference = {NULL, NULL, 0, 0};
+    bool success = heap != NULL;
+
+    reference.flights = (Flight *)malloc(KEYS * sizeof(Flight));
+    reference.arrivals = (uint32_t *)malloc(KEYS * sizeof(uint32_t));
+
+    if (reference.flights == NULL || reference.arrivals == NULL)
+        success = false;
+
+    for (size_t i = 0; success && i < OPERATIONS + KEYS; i++)
+    {
+        FlightKey key = (FlightKey)(next_random(&state) % KEYS + 1);
+        size_t idx = reference_find(&reference, key);
+        unsigned choice = (unsigned)(next_random(&state) % 100);
+        Flight expected;
+        Flight removed;
+
+        // Depois das operações sorteadas, só remove do topo até esvaziar
+        if (i >= OPERATIONS)
+            choice = 60;
+
+        if (choice < 40 && idx == reference.size)
+        {
+            Flight flight = random_flight(&state, key);
+
+            reference.flights[reference.size] = flight;
+            reference.arrivals[reference.size] = reference.next_arrival++;
+            reference_sift_up(&reference, reference.size++);
+            success = insert(heap, flight);
+        }
+        else if (choice < 70)
+        {
+            if (reference.size == 0)
+            {
+                success = heap->size == 0;
+                continue;
+            }
+
+            expected = reference_remove(&reference, 0);
+            success = top(heap) != NULL && same_flight(top(heap), &expected);
+            pop(heap);
+        }
+        else if (choice < 85)
+        {
+            bool found = idx < reference.size;
+
+            // A heap vazia recusa a remoção com uma mensagem, sem consultar o código
+            if (reference.size == 0)
+                continue;
+
+            if (found)
+                expected = reference_remove(&reference, idx);
+
+            success = excluir(heap, key, &removed) == found && (!found || same_flight(&removed, &expected));
+        }
+        else
+        {
+            Flight fields = random_flight(&state, key);
+            bool found = idx < reference.size;
+
+            // Como em update_flight, só uma nova prioridade muda a ordem de chegada
+            if (found && fields.priority != reference.flights[idx].priority)
+            {
+                reference.flights[idx] = fields;
+                reference.arrivals[idx] = reference.next_arrival++;
+                reference_sift_up(&reference, idx);
+                reference_heapify(&reference, idx);
+            }
+            else if (found)
+                reference.flights[idx] = fields;
+
+            success = update_flight(heap, key, fields) == found;
+        }
+
+        success = success && heap->size == reference.size;
+
+        if (!success)
+            fprintf(stderr, "Semente %llu: divergencia na operacao %zu.\n", (unsigned long long)seed, i);
+    }
+
+    free(reference.flights);
+    free(reference.arrivals);
+
+    if (heap != NULL)
+        deallocate(&heap);
+
+    return success;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t rounds = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_ROUNDS;
+    size_t failures = 0;
+
+    set_heap_engine(ENGINE_BINARY);
+
+    for (size_t round = 1; round <= rounds; round++)
+        if (!run_round(round))
+            failures++;
+
+    printf("sift (HEAP_ARITY %d, HEAP_BOTTOM_UP %d): %zu rodadas, %zu falhas\n", HEAP_ARITY, HEAP_BOTTOM_UP, rounds,
+           failures);
+
+    return failures == 0 ? 0 : 1;
+}